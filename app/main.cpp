@@ -7,12 +7,28 @@
 int main(int argc, char* argv[])
 {
     std::string mps_path;
+    std::string snapshot_path;
+    std::string write_snapshot_path;
+    std::string solution_path;
     std::string log_level;
+    std::string pricing{"devex"};
+    std::string crash{"none"};
+    bool presolve{false};
+    bool no_perturbation{false};
 
     {
         CommandLine args("jsolve");
         args.addArgument({"-l", "--log"}, &log_level, "Log level [off, info, debug]");
         args.addArgument({"-m", "--mps"}, &mps_path, "Path to MPS file.");
+        args.addArgument({"-s", "--snapshot"}, &snapshot_path, "Path to model snapshot, solved in place of MPS file");
+        args.addArgument(
+            {"--write-snapshot"}, &write_snapshot_path, "Write the MPS file to this snapshot, without solving"
+        );
+        args.addArgument({"--write-solution"}, &solution_path, "Write the solution to this file");
+        args.addArgument({"-p", "--pricing"}, &pricing, "Primal pricing method [dantzig, devex]");
+        args.addArgument({"-c", "--crash"}, &crash, "Starting basis [none, bixby]");
+        args.addArgument({"--presolve"}, &presolve, "Reduce the model before solving, leaving out the duals");
+        args.addArgument({"--no-perturbation"}, &no_perturbation, "Do not perturb bounds or costs when stalling");
 
         try
         {
@@ -29,7 +45,24 @@ int main(int argc, char* argv[])
     {
         logging::init_logging(log_level);
         Timer timer{info_logger(), "Running jsolve"};
-        go(mps_path);
+        jsolve::Options options{};
+        options.primal_pricing = jsolve::parse_pricing(pricing);
+        options.crash = jsolve::parse_crash(crash);
+        options.presolve = presolve;
+        options.perturbation = !no_perturbation;
+
+        if (!write_snapshot_path.empty())
+        {
+            convert(mps_path, write_snapshot_path);
+        }
+        else if (!snapshot_path.empty())
+        {
+            go(snapshot_path, Input::SNAPSHOT, solution_path, options);
+        }
+        else
+        {
+            go(mps_path, Input::MPS, solution_path, options);
+        }
     }
     catch (std::exception const& e)
     {
@@ -5,21 +5,36 @@
 
 #include "jsolve.h"
 #include "mps.h"
+#include "snapshot.h"
 
 #include "matrix.h"
 
-void go(std::filesystem::path file)
+void go(std::filesystem::path file, Input input, std::filesystem::path solution_file, const jsolve::Options& options)
 {
-    auto model{jsolve::read_mps(file)};
+    auto model{input == Input::SNAPSHOT ? jsolve::read_snapshot(file) : jsolve::read_mps(file)};
 
     // auto model = models::make_model_10();
 
     log()->info(model.to_string());
 
-    auto solution{jsolve::solve(model)};
+    auto solution{jsolve::solve(model, options)};
 
     if (solution)
     {
         jsolve::log_solution(debug_logger(), solution.value());
+
+        if (!solution_file.empty())
+        {
+            jsolve::write_solution(solution.value(), solution_file);
+        }
     }
 }
+
+void convert(std::filesystem::path mps_file, std::filesystem::path snapshot_file)
+{
+    auto model{jsolve::read_mps(mps_file)};
+
+    log()->info(model.to_string());
+
+    jsolve::write_snapshot(model, snapshot_file);
+}
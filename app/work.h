@@ -1,5 +1,17 @@
 #pragma once
 
+#include "options.h"
+
 #include <filesystem>
 
-void go(std::filesystem::path file);
+enum class Input
+{
+    MPS,
+    SNAPSHOT
+};
+
+// Solve a model, writing its solution to solution_file unless that is empty
+void go(std::filesystem::path file, Input input, std::filesystem::path solution_file, const jsolve::Options& options);
+
+// Read an MPS file and write it as a model snapshot
+void convert(std::filesystem::path mps_file, std::filesystem::path snapshot_file);
@@ -2,6 +2,8 @@
 
 #include "bench.h"
 
+#include <cstdint>
+
 using Matr = Matrix<double>;
 
 static void bench_jsolve(benchmark::State& state)
@@ -21,4 +23,33 @@ static void bench_jsolve(benchmark::State& state)
 // Register the function as a benchmark
 BENCHMARK(bench_jsolve)->DenseRange(1, 1000, 10)->Complexity(benchmark::oN);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+static void bench_read_mps(benchmark::State& state, std::string file_name)
+{
+    // Reports the reader throughput in bytes per second of MPS text
+    auto path = get_netlib_mps(file_name);
+    auto bytes = static_cast<std::int64_t>(std::filesystem::file_size(path));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(jsolve::read_mps(path));
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK_CAPTURE(bench_read_mps, dfl001, std::string{"dfl001.mps"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_read_mps, fit2p, std::string{"fit2p.mps"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_read_mps, pilot87, std::string{"pilot87.mps"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_read_mps, wood1p, std::string{"wood1p.mps"})->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+    // The MPS reader logs through the global logger, so it is set up before running
+    logging::init_logging("off");
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
\ No newline at end of file
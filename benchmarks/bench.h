@@ -4,4 +4,16 @@
 
 // TODO: Reference additional headers your program requires here.
 
+#include "logging.h"
 #include "matrix.h"
+#include "mps.h"
+
+#include <filesystem>
+#include <source_location>
+#include <string>
+
+inline std::filesystem::path get_netlib_mps(std::string file_name)
+{
+    return std::filesystem::path{std::source_location::current().file_name()}.remove_filename() / ".." / "netlib" /
+           "mps" / file_name;
+}
@@ -1,3 +1,9 @@
+# Use an installed Google Benchmark if there is one, otherwise fetch it
+find_package(benchmark QUIET)
+if (benchmark_FOUND)
+    return()
+endif()
+
 # Disable the Google Benchmark requirement on Google Test
 set(BENCHMARK_ENABLE_TESTING NO)
 
@@ -1,7 +1,28 @@
 #include "models.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace models
 {
+namespace
+{
+struct Random
+{
+    // Small linear congruential generator, so the generated models are the same everywhere
+    std::uint64_t state;
+
+    double next()
+    {
+        state = (state * 1103515245 + 12345) % (std::uint64_t{1} << 31);
+        return static_cast<double>(state) / static_cast<double>(std::uint64_t{1} << 31);
+    }
+
+    int below(int n) { return static_cast<int>(next() * n); }
+};
+} // namespace
+
 jsolve::Model make_model_0()
 {
     // Model from:
@@ -1309,4 +1330,171 @@ jsolve::Model make_model_28()
     return m;
 }
 
+jsolve::Model make_model_29()
+{
+    // Fabricated model with free, negative and boxed variables.
+    // Optimal at x1 = -2, x2 = 3, x3 = 1, x4 = -1 with objective 2.
+
+    auto m = jsolve::Model(jsolve::Model::Sense::MAX, "JR_BOUNDS");
+
+    auto* x1 = m.make_variable(jsolve::Variable::Type::LINEAR, "x1");
+    auto* x2 = m.make_variable(jsolve::Variable::Type::LINEAR, "x2");
+    auto* x3 = m.make_variable(jsolve::Variable::Type::LINEAR, "x3");
+    auto* x4 = m.make_variable(jsolve::Variable::Type::LINEAR, "x4");
+
+    x1->cost() = 1;
+    x2->cost() = 2;
+    x3->cost() = -1;
+    x4->cost() = 1;
+
+    x1->lower_bound() = -std::numeric_limits<double>::infinity();
+    x2->lower_bound() = -2;
+    x2->upper_bound() = 3;
+    x3->lower_bound() = 1;
+    x4->lower_bound() = -5;
+    x4->upper_bound() = -1;
+
+    {
+        auto* c = m.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+        c->rhs() = 1;
+        c->add_to_lhs(1, x1);
+        c->add_to_lhs(1, x2);
+    }
+
+    {
+        auto* c = m.make_constraint(jsolve::Constraint::Type::GREAT, "C2");
+        c->rhs() = -10;
+        c->add_to_lhs(1, x1);
+        c->add_to_lhs(-1, x3);
+        c->add_to_lhs(1, x4);
+    }
+
+    {
+        auto* c = m.make_constraint(jsolve::Constraint::Type::GREAT, "C3");
+        c->rhs() = -20;
+        c->add_to_lhs(1, x1);
+        c->add_to_lhs(-1, x2);
+    }
+
+    return m;
+}
+
+jsolve::Model make_model_30()
+{
+    // Fabricated model where the dual simplex flips boxed variables in its ratio test.
+    // Optimal at x1 = 1, x2 = 1, x3 = 0.5 with objective 4.5.
+
+    auto m = jsolve::Model(jsolve::Model::Sense::MIN, "JR_FLIPS");
+
+    auto* x1 = m.make_variable(jsolve::Variable::Type::LINEAR, "x1");
+    auto* x2 = m.make_variable(jsolve::Variable::Type::LINEAR, "x2");
+    auto* x3 = m.make_variable(jsolve::Variable::Type::LINEAR, "x3");
+
+    x1->cost() = 1;
+    x2->cost() = 2;
+    x3->cost() = 3;
+
+    x1->upper_bound() = 1;
+    x2->upper_bound() = 1;
+    x3->upper_bound() = 1;
+
+    {
+        auto* c = m.make_constraint(jsolve::Constraint::Type::GREAT, "C1");
+        c->rhs() = 2.5;
+        c->add_to_lhs(1, x1);
+        c->add_to_lhs(1, x2);
+        c->add_to_lhs(1, x3);
+    }
+
+    return m;
+}
+
+jsolve::Model make_model_31()
+{
+    // Fabricated model that stalls the primal simplex: max c^T x st x_j - x_k <= 0 for 300 random pairs and
+    // sum x <= 10, over 60 variables with costs 1 to 5. The all slack basis is primal feasible and the vertex at 0 is
+    // degenerate in every pair row, so over 50 iterations in a row are degenerate and the bounds get perturbed.
+    // Optimal objective 95 / 3.
+
+    auto m = jsolve::Model(jsolve::Model::Sense::MAX, "JR_ORDER");
+
+    Random random{1};
+
+    std::vector<jsolve::Variable*> x;
+    for (int n_var = 0; n_var < 60; n_var++)
+    {
+        x.push_back(m.make_variable(jsolve::Variable::Type::LINEAR, "x" + std::to_string(n_var)));
+    }
+
+    for (int n_cons = 0; n_cons < 300; n_cons++)
+    {
+        const auto j = random.below(60);
+        const auto k = random.below(60);
+        if (j == k)
+        {
+            continue;
+        }
+
+        auto* c = m.make_constraint(jsolve::Constraint::Type::LESS, "R" + std::to_string(n_cons));
+        c->rhs() = 0;
+        c->add_to_lhs(1, x[j]);
+        c->add_to_lhs(-1, x[k]);
+    }
+
+    for (auto* v : x)
+    {
+        v->cost() = 1 + random.below(5);
+    }
+
+    {
+        auto* c = m.make_constraint(jsolve::Constraint::Type::LESS, "SUM");
+        c->rhs() = 10;
+        for (auto* v : x)
+        {
+            c->add_to_lhs(1, v);
+        }
+    }
+
+    return m;
+}
+
+jsolve::Model make_model_32()
+{
+    // Fabricated model that stalls the dual simplex: a 20 x 20 assignment problem with costs 0 to 2, plus 1 for the
+    // first five rows. Costs are all non-negative so the all slack basis is dual feasible, and with so many ties
+    // over 50 iterations in a row are dual degenerate and the costs get perturbed.
+    // Optimal objective 5, as each of the first five rows costs at least 1.
+
+    auto m = jsolve::Model(jsolve::Model::Sense::MIN, "JR_ASSIGN");
+
+    Random random{1};
+
+    std::vector<jsolve::Constraint*> supply;
+    std::vector<jsolve::Constraint*> demand;
+    for (int n = 0; n < 20; n++)
+    {
+        supply.push_back(m.make_constraint(jsolve::Constraint::Type::EQUAL, "S" + std::to_string(n)));
+        supply.back()->rhs() = 1;
+    }
+    for (int n = 0; n < 20; n++)
+    {
+        demand.push_back(m.make_constraint(jsolve::Constraint::Type::EQUAL, "D" + std::to_string(n)));
+        demand.back()->rhs() = 1;
+    }
+
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j < 20; j++)
+        {
+            const auto name = "x" + std::to_string(i) + "_" + std::to_string(j);
+            auto* v = m.make_variable(jsolve::Variable::Type::LINEAR, name);
+            v->cost() = (i < 5 ? 1 : 0) + random.below(3);
+            supply[i]->add_to_lhs(1, v);
+            demand[j]->add_to_lhs(1, v);
+        }
+    }
+
+    return m;
+}
+
 } // namespace models
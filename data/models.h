@@ -31,4 +31,8 @@ jsolve::Model make_model_25();
 jsolve::Model make_model_26();
 jsolve::Model make_model_27();
 jsolve::Model make_model_28();
+jsolve::Model make_model_29();
+jsolve::Model make_model_30();
+jsolve::Model make_model_31();
+jsolve::Model make_model_32();
 } // namespace models
\ No newline at end of file
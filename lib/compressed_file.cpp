@@ -0,0 +1,242 @@
+#include "compressed_file.h"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#ifdef JSOLVE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef JSOLVE_HAS_BZIP2
+#include <bzlib.h>
+#endif
+
+namespace jsolve
+{
+std::optional<CompressedFile::Format> CompressedFile::detect(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::in | std::ios::binary};
+
+    std::array<unsigned char, 4> magic{};
+    file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+
+    const auto n_read = static_cast<std::size_t>(file.gcount());
+
+    if (n_read >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+    {
+        return Format::GZIP;
+    }
+    else if (n_read >= 3 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h')
+    {
+        return Format::BZIP2;
+    }
+    else if (n_read >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+    {
+        return Format::ZSTD;
+    }
+
+    return std::nullopt;
+}
+
+bool CompressedFile::supported(Format format)
+{
+    switch (format)
+    {
+    case Format::GZIP:
+#ifdef JSOLVE_HAS_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Format::BZIP2:
+#ifdef JSOLVE_HAS_BZIP2
+        return true;
+#else
+        return false;
+#endif
+    case Format::ZSTD:
+        return false;
+    }
+
+    return false;
+}
+
+CompressedFile::CompressedFile(const std::filesystem::path& path, Format format, std::size_t block_size)
+    : m_block_size{block_size}
+{
+    if (!supported(format))
+    {
+        throw std::runtime_error("Compression format not supported by this build");
+    }
+
+    m_thread = std::jthread{[this, path, format](std::stop_token stop) { decompress(stop, path, format); }};
+}
+
+CompressedFile::~CompressedFile() = default;
+
+bool CompressedFile::next_block(std::string& block)
+{
+    std::unique_lock lock{m_mutex};
+    m_changed.wait(lock, [this] { return !m_blocks.empty() || m_done; });
+
+    if (!m_blocks.empty())
+    {
+        block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        m_changed.notify_all();
+        return true;
+    }
+
+    if (m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+
+    return false;
+}
+
+bool CompressedFile::push(const std::stop_token& stop, std::string block)
+{
+    // Waits for room in the queue, returning false if the reader has gone
+
+    std::unique_lock lock{m_mutex};
+
+    if (!m_changed.wait(lock, stop, [this] { return m_blocks.size() < max_queued; }))
+    {
+        return false;
+    }
+
+    m_blocks.push_back(std::move(block));
+    m_changed.notify_all();
+    return true;
+}
+
+void CompressedFile::decompress(std::stop_token stop, std::filesystem::path path, Format format)
+{
+    // Runs on m_thread, filling blocks until the end of the file, an error or a stop request
+
+    try
+    {
+        if (format == Format::GZIP)
+        {
+#ifdef JSOLVE_HAS_ZLIB
+            // gzread also reads files made of several concatenated gzip members
+            std::unique_ptr<gzFile_s, decltype(&gzclose)> file{gzopen(path.string().c_str(), "rb"), &gzclose};
+
+            if (!file)
+            {
+                throw std::runtime_error("Could not open gzip file");
+            }
+
+            gzbuffer(file.get(), 1 << 18);
+
+            while (!stop.stop_requested())
+            {
+                std::string block(m_block_size, '\0');
+                const int n_read = gzread(file.get(), block.data(), static_cast<unsigned>(block.size()));
+
+                // A file cut short reads as the end of the file, with the error only given by gzerror
+                int error{Z_OK};
+                gzerror(file.get(), &error);
+
+                if (n_read < 0 || (error != Z_OK && error != Z_STREAM_END))
+                {
+                    throw std::runtime_error("Corrupt gzip data");
+                }
+                else if (n_read == 0)
+                {
+                    break;
+                }
+
+                block.resize(static_cast<std::size_t>(n_read));
+
+                if (!push(stop, std::move(block)))
+                {
+                    break;
+                }
+            }
+#endif
+        }
+        else if (format == Format::BZIP2)
+        {
+#ifdef JSOLVE_HAS_BZIP2
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.string().c_str(), "rb"),
+                                                                     &std::fclose};
+
+            if (!file)
+            {
+                throw std::runtime_error("Could not open bzip2 file");
+            }
+
+            // Parallel compressors write several bzip2 streams one after another, each is read in turn starting
+            // from the bytes the last one read past its end
+            std::string unused;
+            bool more_streams{true};
+
+            while (more_streams && !stop.stop_requested())
+            {
+                int error{BZ_OK};
+                BZFILE* stream =
+                    BZ2_bzReadOpen(&error, file.get(), 0, 0, unused.data(), static_cast<int>(unused.size()));
+
+                if (error != BZ_OK)
+                {
+                    BZ2_bzReadClose(&error, stream);
+                    throw std::runtime_error("Could not open bzip2 stream");
+                }
+
+                while (error == BZ_OK && !stop.stop_requested())
+                {
+                    std::string block(m_block_size, '\0');
+                    const int n_read = BZ2_bzRead(&error, stream, block.data(), static_cast<int>(block.size()));
+
+                    if (error != BZ_OK && error != BZ_STREAM_END)
+                    {
+                        BZ2_bzReadClose(&error, stream);
+                        throw std::runtime_error("Corrupt bzip2 data");
+                    }
+
+                    block.resize(static_cast<std::size_t>(n_read));
+
+                    if (!block.empty() && !push(stop, std::move(block)))
+                    {
+                        error = BZ_OK;
+                        more_streams = false;
+                        break;
+                    }
+                }
+
+                if (error == BZ_STREAM_END)
+                {
+                    void* next{nullptr};
+                    int n_next{0};
+                    BZ2_bzReadGetUnused(&error, stream, &next, &n_next);
+                    unused.assign(static_cast<const char*>(next), static_cast<std::size_t>(n_next));
+
+                    more_streams = !unused.empty() || std::fgetc(file.get()) != EOF;
+                    if (more_streams && unused.empty())
+                    {
+                        std::fseek(file.get(), -1, SEEK_CUR);
+                    }
+                }
+
+                BZ2_bzReadClose(&error, stream);
+            }
+#endif
+        }
+    }
+    catch (...)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_error = std::current_exception();
+    }
+
+    std::scoped_lock lock{m_mutex};
+    m_done = true;
+    m_changed.notify_all();
+}
+} // namespace jsolve
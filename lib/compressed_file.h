@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace jsolve
+{
+class CompressedFile
+{
+    // A compressed file read as blocks of decompressed bytes. Blocks are decompressed on a separate thread, a few
+    // ahead of the reader, so decompressing and reading overlap and the whole text is never held in memory.
+    // Errors from the decompressing thread are rethrown by next_block as std::runtime_error.
+
+  public:
+    enum class Format
+    {
+        GZIP,
+        BZIP2,
+        ZSTD
+    };
+
+    // The format given by the first bytes of the file, none if it is not compressed
+    static std::optional<Format> detect(const std::filesystem::path& path);
+
+    // Whether this build can decompress the format
+    static bool supported(Format format);
+
+    static constexpr std::size_t default_block_size{std::size_t{1} << 22};
+
+    CompressedFile(const std::filesystem::path& path, Format format, std::size_t block_size = default_block_size);
+    ~CompressedFile();
+
+    CompressedFile(const CompressedFile&) = delete;
+    CompressedFile& operator=(const CompressedFile&) = delete;
+
+    // Replaces block with the next block, returning false at the end of the file
+    bool next_block(std::string& block);
+
+  private:
+    void decompress(std::stop_token stop, std::filesystem::path path, Format format);
+    bool push(const std::stop_token& stop, std::string block);
+
+    static constexpr std::size_t max_queued{4};
+
+    std::size_t m_block_size;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_changed;
+    std::deque<std::string> m_blocks;
+    bool m_done{false};
+    std::exception_ptr m_error;
+
+    std::jthread m_thread; // Last, so it is stopped and joined before the queue is destroyed
+};
+} // namespace jsolve
@@ -37,6 +37,16 @@ double& Constraint::rhs()
     return m_rhs;
 }
 
+double Constraint::range() const
+{
+    return m_range;
+}
+
+double& Constraint::range()
+{
+    return m_range;
+}
+
 void Constraint::add_to_lhs(double coeff, Variable* var)
 {
     m_entries[var] += coeff;
@@ -47,12 +57,12 @@ void Constraint::add_to_rhs(double coeff, Variable* var)
     add_to_lhs(-1 * coeff, var);
 }
 
-const std::map<Variable*, double, Variable::CompareNames>& Constraint::entries() const
+const Constraint::Entries& Constraint::entries() const
 {
     return m_entries;
 }
 
-std::map<Variable*, double, Variable::CompareNames>& Constraint::entries()
+Constraint::Entries& Constraint::entries()
 {
     return m_entries;
 }
@@ -94,6 +104,11 @@ std::string Constraint::to_string() const
 
     s.append(fmt::format("{}", rhs()));
 
+    if (m_range < std::numeric_limits<double>::infinity())
+    {
+        s.append(fmt::format(" (range {})", m_range));
+    }
+
     return s;
 }
 
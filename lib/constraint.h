@@ -1,9 +1,10 @@
 #pragma once
 
 #include "counter.h"
+#include "flat_map.h"
 #include "variable.h"
 
-#include <map>
+#include <limits>
 #include <string>
 
 namespace jsolve
@@ -11,6 +12,9 @@ namespace jsolve
 class Constraint : public Counter<Constraint>
 {
   public:
+    // Coefficients in order of variable creation
+    using Entries = FlatMap<Variable*, double, Variable::CompareIds>;
+
     enum class Type
     {
         LESS,
@@ -26,8 +30,13 @@ class Constraint : public Counter<Constraint>
     double rhs() const;
     double& rhs();
 
-    const std::map<Variable*, double, Variable::CompareNames>& entries() const;
-    std::map<Variable*, double, Variable::CompareNames>& entries();
+    // A ranged row is bounded on both sides: rhs - range <= lhs <= rhs for LESS, rhs <= lhs <= rhs + range for
+    // GREAT. Infinite otherwise.
+    double range() const;
+    double& range();
+
+    const Entries& entries() const;
+    Entries& entries();
 
     void add_to_lhs(double coeff, Variable* var);
     void add_to_rhs(double coeff, Variable* var);
@@ -39,7 +48,8 @@ class Constraint : public Counter<Constraint>
   private:
     Type m_type{Type::LESS};
     double m_rhs{0.0};
-    std::map<Variable*, double, Variable::CompareNames> m_entries;
+    double m_range{std::numeric_limits<double>::infinity()};
+    Entries m_entries;
 };
 
 std::ostream& operator<<(std::ostream& os, const Constraint& c);
@@ -2,6 +2,8 @@
 
 #include "logging.h"
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 template <typename T>
@@ -9,16 +11,16 @@ class Counter
 {
   public:
     Counter(const std::string& name)
-        : m_name{name}
+        : m_name{name},
+          m_id{m_n_created.fetch_add(1)}
     {
-        ++m_n_created;
         ++m_n_alive;
     }
 
     Counter(const Counter& other)
-        : m_name{other.m_name}
+        : m_name{other.m_name},
+          m_id{m_n_created.fetch_add(1)}
     {
-        ++m_n_created;
         ++m_n_alive;
     }
 
@@ -27,12 +29,19 @@ class Counter
         return m_name;
     }
 
-    static int n_created()
+    // Unique and increasing in order of creation, so comparing ids is cheaper than comparing names.
+    // Taken from an atomic 64 bit count, so ids stay unique across threads and however many models are made.
+    std::uint64_t id() const
+    {
+        return m_id;
+    }
+
+    static std::uint64_t n_created()
     {
         return m_n_created;
     }
 
-    static int n_alive()
+    static std::int64_t n_alive()
     {
         return m_n_alive;
     }
@@ -50,6 +59,14 @@ class Counter
         }
     };
 
+    struct CompareIds
+    {
+        bool operator()(const Counter<T>* lhs, const Counter<T>* rhs) const
+        {
+            return lhs->id() < rhs->id();
+        }
+    };
+
   protected:
     ~Counter()
     {
@@ -58,8 +75,9 @@ class Counter
 
   private:
     std::string m_name;
-    static inline int m_n_created = 0;
-    static inline int m_n_alive = 0;
+    std::uint64_t m_id;
+    static inline std::atomic<std::uint64_t> m_n_created{0};
+    static inline std::atomic<std::int64_t> m_n_alive{0};
 };
 
 template <typename T>
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class FlatMap
+{
+    // Map held as one vector of (key, value) pairs sorted by key, in place of the tree nodes of a std::map.
+    // Lookups are a binary search, and inserting a key larger than all others (the usual case when a model is
+    // read in column order) appends. Inserting or erasing elsewhere moves the later entries along.
+    // Iterators and references are invalidated by any insert or erase.
+
+  public:
+    using value_type = std::pair<Key, T>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    FlatMap() = default;
+
+    std::size_t size() const;
+    bool empty() const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+    bool contains(const Key& key) const;
+
+    T& at(const Key& key);
+    const T& at(const Key& key) const;
+
+    // Insert the key if missing, returning the position and whether it was inserted
+    std::pair<iterator, bool> try_emplace(const Key& key, T value = T{});
+
+    // Returns the number of entries removed
+    std::size_t erase(const Key& key);
+
+    template <typename Predicate>
+    std::size_t erase_if(Predicate predicate);
+
+    void reserve(std::size_t size);
+
+    // Operators -------------------------------------------------------------------------------
+
+    // Access, inserting a value-initialised entry if the key is missing
+    T& operator[](const Key& key);
+
+  private:
+    iterator lower_bound(const Key& key);
+    const_iterator lower_bound(const Key& key) const;
+
+    std::vector<value_type> m_entries;
+    Compare m_compare;
+};
+
+// FlatMap:: member functions
+template <typename Key, typename T, typename Compare>
+std::size_t FlatMap<Key, T, Compare>::size() const
+{
+    return m_entries.size();
+}
+
+template <typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::empty() const
+{
+    return m_entries.empty();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::begin()
+{
+    return m_entries.begin();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::end()
+{
+    return m_entries.end();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::begin() const
+{
+    return m_entries.begin();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::end() const
+{
+    return m_entries.end();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::lower_bound(const Key& key)
+{
+    return std::lower_bound(m_entries.begin(), m_entries.end(), key, [this](const auto& entry, const Key& k) {
+        return m_compare(entry.first, k);
+    });
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::lower_bound(const Key& key) const
+{
+    return std::lower_bound(m_entries.begin(), m_entries.end(), key, [this](const auto& entry, const Key& k) {
+        return m_compare(entry.first, k);
+    });
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::find(const Key& key)
+{
+    auto it = lower_bound(key);
+    return it != m_entries.end() && !m_compare(key, it->first) ? it : m_entries.end();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::find(const Key& key) const
+{
+    auto it = lower_bound(key);
+    return it != m_entries.end() && !m_compare(key, it->first) ? it : m_entries.end();
+}
+
+template <typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::contains(const Key& key) const
+{
+    return find(key) != m_entries.end();
+}
+
+template <typename Key, typename T, typename Compare>
+T& FlatMap<Key, T, Compare>::at(const Key& key)
+{
+    auto it = find(key);
+    if (it == m_entries.end())
+    {
+        throw std::out_of_range("FlatMap::at");
+    }
+    return it->second;
+}
+
+template <typename Key, typename T, typename Compare>
+const T& FlatMap<Key, T, Compare>::at(const Key& key) const
+{
+    auto it = find(key);
+    if (it == m_entries.end())
+    {
+        throw std::out_of_range("FlatMap::at");
+    }
+    return it->second;
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename FlatMap<Key, T, Compare>::iterator, bool> FlatMap<Key, T, Compare>::try_emplace(const Key& key,
+                                                                                                    T value)
+{
+    // Appending is checked first, as entries mostly arrive in order
+    if (m_entries.empty() || m_compare(m_entries.back().first, key))
+    {
+        m_entries.emplace_back(key, std::move(value));
+        return {std::prev(m_entries.end()), true};
+    }
+
+    auto it = lower_bound(key);
+    if (it != m_entries.end() && !m_compare(key, it->first))
+    {
+        return {it, false};
+    }
+
+    return {m_entries.emplace(it, key, std::move(value)), true};
+}
+
+template <typename Key, typename T, typename Compare>
+std::size_t FlatMap<Key, T, Compare>::erase(const Key& key)
+{
+    auto it = find(key);
+    if (it == m_entries.end())
+    {
+        return 0;
+    }
+    m_entries.erase(it);
+    return 1;
+}
+
+template <typename Key, typename T, typename Compare>
+template <typename Predicate>
+std::size_t FlatMap<Key, T, Compare>::erase_if(Predicate predicate)
+{
+    return std::erase_if(m_entries, predicate);
+}
+
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::reserve(std::size_t size)
+{
+    m_entries.reserve(size);
+}
+
+template <typename Key, typename T, typename Compare>
+T& FlatMap<Key, T, Compare>::operator[](const Key& key)
+{
+    return try_emplace(key).first->second;
+}
@@ -2,5 +2,6 @@
 
 #include "constraint.h"
 #include "model.h"
+#include "options.h"
 #include "simplex.h"
 #include "variable.h"
\ No newline at end of file
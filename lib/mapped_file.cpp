@@ -0,0 +1,91 @@
+#include "mapped_file.h"
+
+#include <system_error>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jsolve
+{
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::in | std::ios::binary};
+
+    if (!file.is_open())
+    {
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), path.string());
+    }
+
+    m_buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+#else
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), path.string());
+    }
+
+    struct stat status
+    {
+    };
+
+    if (::fstat(fd, &status) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), path.string());
+    }
+
+    m_size = static_cast<std::size_t>(status.st_size);
+
+    // An empty file cannot be mapped, it is left as an empty view
+    if (m_size > 0)
+    {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path.string());
+        }
+
+        // The file is read front to back once
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+#endif
+
+std::string_view MappedFile::view() const
+{
+    return {m_data, m_size};
+}
+} // namespace jsolve
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace jsolve
+{
+class MappedFile
+{
+    // Read-only view of a whole file, memory-mapped where the platform allows (POSIX) and otherwise read into a
+    // buffer with a single read. Throws std::system_error if the file cannot be opened.
+
+  public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const;
+
+  private:
+    const char* m_data{nullptr};
+    std::size_t m_size{0};
+#ifdef _WIN32
+    std::string m_buffer;
+#endif
+};
+} // namespace jsolve
@@ -42,36 +42,77 @@ double Model::constant() const
     return m_constant;
 }
 
-Variable* Model::make_variable(Variable::Type type, const std::string& name)
+namespace
+{
+template <typename T>
+T* make(std::vector<std::unique_ptr<T>>& items, std::unordered_map<std::string_view, std::size_t>& indices,
+        std::unique_ptr<T> item, std::string_view kind)
 {
-    auto [it, result] = m_variables.try_emplace(name, nullptr);
+    // Add an item at the end, keyed by a view of its own name so the name is stored once.
 
-    if (result)
-    {
-        it->second = std::make_unique<Variable>(type, name);
-    }
-    else
+    auto [it, result] = indices.try_emplace(item->name(), items.size());
+
+    if (!result)
     {
-        throw ModelError(fmt::format("Variable name {} already exists", name));
+        throw ModelError(fmt::format("{} name {} already exists", kind, item->name()));
     }
 
-    return it->second.get();
+    items.push_back(std::move(item));
+    return items.back().get();
 }
 
-Constraint* Model::make_constraint(Constraint::Type type, const std::string& name)
+template <typename T>
+T* find(const std::vector<std::unique_ptr<T>>& items, const std::unordered_map<std::string_view, std::size_t>& indices,
+        std::string_view name)
 {
-    auto [it, result] = m_constraints.try_emplace(name, nullptr);
+    auto found = indices.find(name);
+    return found == std::end(indices) ? nullptr : items[found->second].get();
+}
+
+template <typename T>
+void remove(std::vector<std::unique_ptr<T>>& items, std::unordered_map<std::string_view, std::size_t>& indices,
+            std::vector<std::unique_ptr<T>>& removed, std::string_view name)
+{
+    // Move the last item into the place of the removed one, so removal does not shift the rest.
+    // The removed item itself is kept aside rather than destroyed.
+
+    auto found = indices.find(name);
 
-    if (result)
+    if (found == std::end(indices))
     {
-        it->second = std::make_unique<Constraint>(type, name);
+        return;
     }
-    else
+
+    const auto index = found->second;
+    indices.erase(found);
+    removed.push_back(std::move(items[index]));
+
+    if (index + 1 != items.size())
     {
-        throw ModelError(fmt::format("Constraint name {} already exists", name));
+        items[index] = std::move(items.back());
+        indices.at(items[index]->name()) = index;
     }
 
-    return it->second.get();
+    items.pop_back();
+}
+} // namespace
+
+Variable* Model::make_variable(Variable::Type type, const std::string& name)
+{
+    return make(m_variables, m_variable_indices, std::make_unique<Variable>(type, name), "Variable");
+}
+
+Constraint* Model::make_constraint(Constraint::Type type, const std::string& name)
+{
+    return make(m_constraints, m_constraint_indices, std::make_unique<Constraint>(type, name), "Constraint");
+}
+
+void Model::reserve(std::size_t n_variables, std::size_t n_constraints)
+{
+    m_variables.reserve(n_variables);
+    m_variable_indices.reserve(n_variables);
+    m_constraints.reserve(n_constraints);
+    m_constraint_indices.reserve(n_constraints);
 }
 
 std::string Model::to_long_string() const
@@ -111,22 +152,19 @@ std::string Model::to_long_string() const
         s.append(fmt::format(" {}", m_constant));
     }
 
-    auto it = std::begin(m_variables);
-    while (it != std::end(m_variables))
+    for (const auto& variable : m_variables)
     {
-        const auto& variable = it->second;
         if (variable->cost() != 0)
         {
             s.append(" + ");
             s.append(fmt::format("{}*{}", variable->cost(), variable->name()));
         }
-        it++;
     }
     s.append("\n");
     s.append("Subject to:");
     s.append("\n");
     // Constraints
-    for (const auto& [name, constraint] : m_constraints)
+    for (const auto& constraint : m_constraints)
     {
         s.append(constraint->to_string());
         s.append("\n");
@@ -145,56 +183,67 @@ std::string Model::to_string() const
     return s;
 }
 
-const std::map<std::string, std::unique_ptr<Variable>>& Model::get_variables() const
+const std::vector<std::unique_ptr<Variable>>& Model::get_variables() const
 {
     return m_variables;
 }
 
-const std::map<std::string, std::unique_ptr<Constraint>>& Model::get_constraints() const
+const std::vector<std::unique_ptr<Constraint>>& Model::get_constraints() const
 {
     return m_constraints;
 }
 
-Variable* Model::get_variable(const std::string& name) const
+Variable* Model::get_variable(std::string_view name) const
 {
-    auto found = m_variables.find(name);
-    return found == std::end(m_variables) ? nullptr : found->second.get();
+    return find(m_variables, m_variable_indices, name);
 }
 
 Variable* Model::get_variable(std::size_t index) const
 {
-    // Added until we get a better way of tracking indices during solve.
-    if (m_variables.size() <= index)
-    {
-        return nullptr;
-    }
-    else
-    {
-        auto it = std::begin(m_variables);
-        std::advance(it, index);
-        return it->second.get();
-    }
+    return index < m_variables.size() ? m_variables[index].get() : nullptr;
+}
+
+Constraint* Model::get_constraint(std::string_view name) const
+{
+    return find(m_constraints, m_constraint_indices, name);
 }
 
-Constraint* Model::get_constraint(const std::string& name) const
+Constraint* Model::get_constraint(std::size_t index) const
 {
-    auto found = m_constraints.find(name);
-    return found == std::end(m_constraints) ? nullptr : found->second.get();
+    return index < m_constraints.size() ? m_constraints[index].get() : nullptr;
 }
 
-void Model::remove_variable(const std::string& name)
+void Model::remove_variable(std::string_view name)
 {
-    for (auto& [constraint_name, constraint] : m_constraints)
+    // Looks through every constraint, use the overload below when the constraints containing the variable are known.
+
+    auto* variable = get_variable(name);
+
+    for (auto& constraint : m_constraints)
+    {
+        constraint->entries().erase(variable);
+    }
+
+    remove(m_variables, m_variable_indices, m_removed_variables, name);
+}
+
+void Model::remove_variable(std::string_view name, const std::vector<Constraint*>& constraints)
+{
+    // Remove a variable that only has entries in the given constraints.
+
+    auto* variable = get_variable(name);
+
+    for (auto* constraint : constraints)
     {
-        constraint->entries().erase(get_variable(name));
+        constraint->entries().erase(variable);
     }
 
-    [[maybe_unused]] auto result = m_variables.erase(name);
+    remove(m_variables, m_variable_indices, m_removed_variables, name);
 }
 
-void Model::remove_constraint(const std::string& name)
+void Model::remove_constraint(std::string_view name)
 {
-    [[maybe_unused]] auto result = m_constraints.erase(name);
+    remove(m_constraints, m_constraint_indices, m_removed_constraints, name);
 }
 
 std::ostream& operator<<(std::ostream& os, const Model& m)
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace jsolve
@@ -40,19 +42,26 @@ class Model : public Counter<Model>
     Variable* make_variable(Variable::Type type, const std::string& name);
     Constraint* make_constraint(Constraint::Type type, const std::string& name);
 
-    Variable* get_variable(const std::string& name) const;
+    // Make room for this many variables and constraints, when the size of the model is known before it is made
+    void reserve(std::size_t n_variables, std::size_t n_constraints);
+
+    Variable* get_variable(std::string_view name) const;
     Variable* get_variable(std::size_t index) const;
 
-    Constraint* get_constraint(const std::string& name) const;
+    Constraint* get_constraint(std::string_view name) const;
+    Constraint* get_constraint(std::size_t index) const;
 
-    void remove_variable(const std::string& name);
-    void remove_constraint(const std::string& name);
+    // Removed variables and constraints are kept until the model is destroyed, so pointers to them stay valid
+    void remove_variable(std::string_view name);
+    void remove_variable(std::string_view name, const std::vector<Constraint*>& constraints);
+    void remove_constraint(std::string_view name);
 
     std::string to_string() const;
     std::string to_long_string() const;
 
-    const std::map<std::string, std::unique_ptr<Variable>>& get_variables() const;
-    const std::map<std::string, std::unique_ptr<Constraint>>& get_constraints() const;
+    // Variables and constraints in the order they were made, removing one moves the last into its place
+    const std::vector<std::unique_ptr<Variable>>& get_variables() const;
+    const std::vector<std::unique_ptr<Constraint>>& get_constraints() const;
 
     friend std::ostream& operator<<(std::ostream& os, const Model& m);
 
@@ -62,8 +71,15 @@ class Model : public Counter<Model>
     std::string m_objective_name;
     double m_constant{0.0};
 
-    std::map<std::string, std::unique_ptr<Variable>> m_variables;
-    std::map<std::string, std::unique_ptr<Constraint>> m_constraints;
+    std::vector<std::unique_ptr<Variable>> m_variables;
+    std::vector<std::unique_ptr<Constraint>> m_constraints;
+
+    std::vector<std::unique_ptr<Variable>> m_removed_variables;
+    std::vector<std::unique_ptr<Constraint>> m_removed_constraints;
+
+    // Name -> index, the keys view the names held by the variables and constraints themselves
+    std::unordered_map<std::string_view, std::size_t> m_variable_indices;
+    std::unordered_map<std::string_view, std::size_t> m_constraint_indices;
 };
 
 std::ostream& operator<<(std::ostream& os, const Model& m);
@@ -1,35 +1,63 @@
 #include "mps.h"
 
+#include "compressed_file.h"
+#include "mapped_file.h"
 #include "tools.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <execution>
+#include <numeric>
 #include <optional>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 namespace
 {
-void process_rows_data_record(jsolve::Model& model, const std::vector<std::string>& words)
+double parse_number(std::string_view word)
+{
+    // std::from_chars does not take a leading '+', which some MPS files write
+    if (word.starts_with('+'))
+    {
+        word.remove_prefix(1);
+    }
+
+    double value{0.0};
+    const auto* end = word.data() + word.size();
+    auto [ptr, error] = std::from_chars(word.data(), end, value);
+
+    if (error != std::errc{} || ptr != end)
+    {
+        throw jsolve::MPSError(fmt::format("Invalid number: {}", word));
+    }
+
+    return value;
+}
+
+void process_rows_data_record(jsolve::Model& model, const std::vector<std::string_view>& words)
 {
     const auto& constraint_type = words.at(0);
     const auto& constraint_name = words.at(1);
 
     if (constraint_type == "N")
     {
-        model.objective_name() = constraint_name;
+        model.objective_name() = std::string{constraint_name};
     }
     else if (constraint_type == "G")
     {
-        model.make_constraint(jsolve::Constraint::Type::GREAT, constraint_name);
+        model.make_constraint(jsolve::Constraint::Type::GREAT, std::string{constraint_name});
     }
     else if (constraint_type == "L")
     {
-        model.make_constraint(jsolve::Constraint::Type::LESS, constraint_name);
+        model.make_constraint(jsolve::Constraint::Type::LESS, std::string{constraint_name});
     }
     else if (constraint_type == "E")
     {
-        model.make_constraint(jsolve::Constraint::Type::EQUAL, constraint_name);
+        model.make_constraint(jsolve::Constraint::Type::EQUAL, std::string{constraint_name});
     }
     else
     {
@@ -37,49 +65,244 @@ void process_rows_data_record(jsolve::Model& model, const std::vector<std::strin
     }
 }
 
-void process_cols_data_record(jsolve::Model& model, const std::vector<std::string>& words)
+void split_words(std::string_view line, std::vector<std::string_view>& words)
 {
-    const auto& variable_name = words.at(0);
+    // Words are views into the line, so the caller's vector is reused rather than allocating per line
+    constexpr std::string_view whitespace{" \t\r"};
 
-    auto* variable = model.get_variable(variable_name);
+    words.clear();
 
-    if (!variable)
+    auto start = line.find_first_not_of(whitespace);
+    while (start != std::string_view::npos)
     {
-        variable = model.make_variable(jsolve::Variable::Type::LINEAR, variable_name);
+        auto end = line.find_first_of(whitespace, start);
+        words.push_back(line.substr(start, end == std::string_view::npos ? end : end - start));
+        start = line.find_first_not_of(whitespace, end);
     }
+}
 
-    auto it = std::cbegin(words);
-    auto it_end = std::cend(words) - 1;
+struct ColumnsChunk
+{
+    // COLUMNS records of a run of whole columns, parsed on one thread.
+    // Rows are resolved through the model's name index, which is only read while chunks are parsed.
 
-    for (; it != it_end; ++it)
+    struct Column
     {
-        it++;
-        auto constraint_name = *it;
-        auto constraint_value = std::stod(*(it + 1));
+        std::string_view name;
+        std::optional<double> cost;
+        std::size_t first_entry;
+    };
 
-        if (model.objective_name() == constraint_name)
+    std::vector<Column> columns;
+    std::vector<std::pair<jsolve::Constraint*, double>> entries;
+    std::optional<std::string> error; // Exceptions cannot leave a parallel algorithm, so the first is kept here
+};
+
+std::string_view next_line(std::string_view text, std::size_t& offset)
+{
+    auto end = text.find('\n', offset);
+    if (end == std::string_view::npos)
+    {
+        end = text.size();
+    }
+
+    auto line = text.substr(offset, end - offset);
+    offset = std::min(end + 1, text.size());
+    return line;
+}
+
+std::string_view column_name(std::string_view line)
+{
+    // First word of a COLUMNS record, empty for comment and blank lines
+
+    if (line.starts_with('*'))
+    {
+        return {};
+    }
+
+    constexpr std::string_view whitespace{" \t\r"};
+
+    auto start = line.find_first_not_of(whitespace);
+    if (start == std::string_view::npos)
+    {
+        return {};
+    }
+
+    auto end = line.find_first_of(whitespace, start);
+    return line.substr(start, end == std::string_view::npos ? end : end - start);
+}
+
+std::vector<std::size_t> split_columns(std::string_view text, std::size_t n_chunks)
+{
+    // Offsets splitting the COLUMNS records into about n_chunks equal parts. Each split is moved forward to the first
+    // line of a new column, so a column is never shared between chunks. The last offset is the end of the text.
+
+    std::vector<std::size_t> offsets{0};
+
+    for (std::size_t chunk{1}; chunk < n_chunks; chunk++)
+    {
+        auto offset = std::max(chunk * text.size() / n_chunks, offsets.back());
+
+        // Start of the next whole line
+        offset = text.find('\n', offset);
+        if (offset == std::string_view::npos)
         {
-            // Pair is specifying the objective coefficient of this variable
-            variable->cost() = constraint_value;
+            break;
         }
-        else
+        offset++;
+
+        std::string_view previous;
+        while (offset < text.size())
+        {
+            auto start = offset;
+            auto name = column_name(next_line(text, offset));
+
+            if (name.empty())
+            {
+                continue;
+            }
+            else if (!previous.empty() && name != previous)
+            {
+                offset = start;
+                break;
+            }
+
+            previous = name;
+        }
+
+        if (offset >= text.size())
         {
-            // Pair is specifying the entries of a constraint
-            auto* constraint = model.get_constraint(constraint_name);
+            break;
+        }
+
+        offsets.push_back(offset);
+    }
+
+    offsets.push_back(text.size());
+    return offsets;
+}
+
+void parse_columns_chunk(const jsolve::Model& model, std::string_view text, ColumnsChunk& chunk)
+{
+    // Each record is a column name then (row, value) pairs, where the objective row gives the cost
+
+    std::vector<std::string_view> words;
+    std::size_t offset{0};
+
+    try
+    {
+        while (offset < text.size())
+        {
+            auto line = next_line(text, offset);
+
+            if (line.starts_with('*'))
+            {
+                continue;
+            }
 
-            if (constraint)
+            split_words(line, words);
+
+            if (words.empty())
             {
-                constraint->add_to_lhs(constraint_value, variable);
+                continue;
             }
-            else
+
+            if (chunk.columns.empty() || chunk.columns.back().name != words.front())
             {
-                throw jsolve::MPSError(fmt::format("Constraint not found: {}", constraint_value));
+                chunk.columns.push_back({words.front(), std::nullopt, chunk.entries.size()});
+            }
+
+            auto& column = chunk.columns.back();
+
+            for (std::size_t pos{1}; pos + 1 < words.size(); pos += 2)
+            {
+                const auto& row_name = words[pos];
+                const auto value = parse_number(words[pos + 1]);
+
+                if (model.objective_name() == row_name)
+                {
+                    column.cost = value;
+                }
+                else if (auto* constraint = model.get_constraint(row_name))
+                {
+                    chunk.entries.emplace_back(constraint, value);
+                }
+                else
+                {
+                    throw jsolve::MPSError(fmt::format("Constraint not found: {}", row_name));
+                }
             }
         }
     }
+    catch (const std::exception& e)
+    {
+        chunk.error = e.what();
+    }
 }
 
-void process_rhs_data_record(jsolve::Model& model, const std::vector<std::string>& words)
+void read_columns_section(jsolve::Model& model, std::string_view text)
+{
+    // The COLUMNS section holds most of the bytes of a model, so it is split into chunks of whole columns that are
+    // parsed in parallel. Variables are then made and the entries added in file order, so the model is the same
+    // whatever the number of chunks.
+
+    constexpr std::size_t min_chunk_bytes{1 << 20};
+
+    const auto n_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    const auto n_chunks = std::clamp<std::size_t>(text.size() / min_chunk_bytes, 1, 4 * n_threads);
+
+    const auto offsets = split_columns(text, n_chunks);
+    std::vector<ColumnsChunk> chunks(offsets.size() - 1);
+
+    std::vector<std::size_t> indices(chunks.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t i) {
+        parse_columns_chunk(model, text.substr(offsets[i], offsets[i + 1] - offsets[i]), chunks[i]);
+    });
+
+    std::size_t n_entries{0};
+
+    for (auto& chunk : chunks)
+    {
+        if (chunk.error)
+        {
+            throw jsolve::MPSError(chunk.error.value());
+        }
+
+        for (std::size_t pos{0}; pos < chunk.columns.size(); pos++)
+        {
+            const auto& column = chunk.columns[pos];
+            const auto last_entry = pos + 1 < chunk.columns.size() ? chunk.columns[pos + 1].first_entry
+                                                                   : chunk.entries.size();
+
+            // A column split over separate runs of records is added to the variable made for its first run
+            auto* variable = model.get_variable(column.name);
+
+            if (!variable)
+            {
+                variable = model.make_variable(jsolve::Variable::Type::LINEAR, std::string{column.name});
+            }
+
+            if (column.cost)
+            {
+                variable->cost() = column.cost.value();
+            }
+
+            for (std::size_t entry{column.first_entry}; entry < last_entry; entry++)
+            {
+                const auto& [constraint, value] = chunk.entries[entry];
+                constraint->add_to_lhs(value, variable);
+            }
+        }
+
+        n_entries += chunk.entries.size();
+    }
+
+    log()->debug("COLUMNS: {} entries read in {} chunks", n_entries, chunks.size());
+}
+
+void process_rhs_data_record(jsolve::Model& model, const std::vector<std::string_view>& words)
 {
     auto it = (words.size() % 2) ? std::cbegin(words) : std::next(std::cbegin(words));
 
@@ -89,7 +312,7 @@ void process_rhs_data_record(jsolve::Model& model, const std::vector<std::string
     {
         it++;
         auto constraint_name = *it;
-        auto rhs = std::stod(*(it + 1));
+        auto rhs = parse_number(*(it + 1));
 
         auto* constraint = model.get_constraint(constraint_name);
 
@@ -108,7 +331,7 @@ void process_rhs_data_record(jsolve::Model& model, const std::vector<std::string
     }
 }
 
-void process_bounds_data_record(jsolve::Model& model, const std::vector<std::string>& words)
+void process_bounds_data_record(jsolve::Model& model, const std::vector<std::string_view>& words)
 {
     // Bounds record could have 4 entries:
     // LO INTBOU    GRDTIMN1         -105
@@ -122,7 +345,7 @@ void process_bounds_data_record(jsolve::Model& model, const std::vector<std::str
     {
         // Lower bound
         auto* variable = model.get_variable(words.size() == 3 ? words.at(1) : words.at(2));
-        const auto& bound_value = std::stod(words.size() == 3 ? words.at(2) : words.at(3));
+        const auto bound_value = parse_number(words.size() == 3 ? words.at(2) : words.at(3));
 
         variable->lower_bound() = bound_value;
     }
@@ -130,23 +353,22 @@ void process_bounds_data_record(jsolve::Model& model, const std::vector<std::str
     {
         // Upper bound
         auto* variable = model.get_variable(words.size() == 3 ? words.at(1) : words.at(2));
-        const auto& bound_value = std::stod(words.size() == 3 ? words.at(2) : words.at(3));
+        const auto bound_value = parse_number(words.size() == 3 ? words.at(2) : words.at(3));
 
-        if (bound_value < 0.0)
-        {
-            // Can't handle negative variables with current simplex implementation.
-            throw jsolve::MPSError(fmt::format("Unhandled MPS upper bounds < 0 for variable: {}", words.at(2)));
-        }
-        else
+        if (bound_value < 0.0 && variable->lower_bound() == 0.0)
         {
-            variable->upper_bound() = bound_value;
+            // A negative upper bound on a default lower bound makes the variable unbounded below
+            log()->warn("Negative upper bound for variable {}, setting lower bound to -inf", variable->name());
+            variable->lower_bound() = -std::numeric_limits<double>::infinity();
         }
+
+        variable->upper_bound() = bound_value;
     }
     else if (bound_type == "FX")
     {
         // Fixed value
         auto* variable = model.get_variable(words.size() == 3 ? words.at(1) : words.at(2));
-        const auto& bound_value = std::stod(words.size() == 3 ? words.at(2) : words.at(3));
+        const auto bound_value = parse_number(words.size() == 3 ? words.at(2) : words.at(3));
         variable->lower_bound() = bound_value;
         variable->upper_bound() = bound_value;
     }
@@ -156,20 +378,32 @@ void process_bounds_data_record(jsolve::Model& model, const std::vector<std::str
         variable->lower_bound() = -std::numeric_limits<double>::infinity();
         variable->upper_bound() = std::numeric_limits<double>::infinity();
     }
+    else if (bound_type == "MI")
+    {
+        auto* variable = model.get_variable(words.at(2));
+        variable->lower_bound() = -std::numeric_limits<double>::infinity();
+    }
+    else if (bound_type == "PL")
+    {
+        auto* variable = model.get_variable(words.at(2));
+        variable->upper_bound() = std::numeric_limits<double>::infinity();
+    }
     else
     {
         throw jsolve::MPSError(fmt::format("Unhandled MPS BOUNDS type: {}", bound_type));
     }
 }
 
-void process_ranges_data_record(jsolve::Model& model, const std::vector<std::string>& words)
+void process_ranges_data_record(jsolve::Model& model, const std::vector<std::string_view>& words)
 {
     // Ranges records are very strange. They define new upper or lower limits on the RHS of constraints.
-    // We process this into new constraints, since we have no concept of general counds.
+    // The constraint keeps a single row with the limits held by its range.
     // For a GEQ constraint, the range value (r) sets a new upper limit, eg:
     // x1 + x2 >= 5 becomes 5 + |r| >= x1 + x2 >= 5
     // For a LEQ constraint, the range value (r) sets a new lower limit, eg:
     // x1 + x2 <= 5 becomes 5 - |r| <= x1 + x2 <= 5
+    // For an EQ constraint, the sign of r says which side moves, eg:
+    // x1 + x2 = 5 becomes 5 + r >= x1 + x2 >= 5 for positive r and 5 >= x1 + x2 >= 5 + r for negative r
 
     auto it = std::cbegin(words);
     auto it_end = std::cend(words) - 1;
@@ -183,36 +417,14 @@ void process_ranges_data_record(jsolve::Model& model, const std::vector<std::str
 
         if (constraint)
         {
-            auto range = std::stod(*(it + 1));
+            auto range = parse_number(*(it + 1));
 
-            if (constraint->type() == jsolve::Constraint::Type::GREAT)
-            {
-                // Add a copy of this constraint changed to which is LEQ, RHS + |r|
-                auto* new_constraint{model.make_constraint(
-                    jsolve::Constraint::Type::LESS, fmt::format("{}_RANGES_GEQ_UPPER", constraint_name)
-                )};
-                new_constraint->entries() = constraint->entries();
-                new_constraint->type() = jsolve::Constraint::Type::LESS;
-                new_constraint->rhs() += std::abs(range);
-            }
-            else if (constraint->type() == jsolve::Constraint::Type::LESS)
-            {
-                // Add a copy of this constraint changed to which is GEQ, RHS - |r|
-                auto* new_constraint{model.make_constraint(
-                    jsolve::Constraint::Type::GREAT, fmt::format("{}_RANGES_LEQ_LOWER", constraint_name)
-                )};
-                new_constraint->entries() = constraint->entries();
-                new_constraint->type() = jsolve::Constraint::Type::GREAT;
-                new_constraint->rhs() -= std::abs(range);
-            }
-            else if (constraint->type() == jsolve::Constraint::Type::EQUAL)
-            {
-                throw jsolve::MPSError("RANGS for EQ not implemented");
-            }
-            else
+            if (constraint->type() == jsolve::Constraint::Type::EQUAL)
             {
-                throw jsolve::MPSError("Impossible");
+                constraint->type() = range < 0 ? jsolve::Constraint::Type::LESS : jsolve::Constraint::Type::GREAT;
             }
+
+            constraint->range() = std::abs(range);
         }
         else
         {
@@ -302,35 +514,24 @@ bool is_indicator_record(std::string_view line)
     }
 }
 
-std::vector<std::string> split_string(const std::string& line)
-{
-    std::istringstream iss{line};
-    std::vector<std::string> result{std::istream_iterator<std::string>{iss}, {}};
-    return result;
-}
-
 void process_indicator_record(
-    std::optional<jsolve::Model>& model, const section& section, const std::vector<std::string>& words
+    std::optional<jsolve::Model>& model, const section& section, const std::vector<std::string_view>& words
 )
 {
     if (section == section::NAME)
     {
-        model.emplace(Model::Sense::MIN, words.size() > 1 ? words.at(1) : "Unnamed");
+        model.emplace(Model::Sense::MIN, words.size() > 1 ? std::string{words.at(1)} : "Unnamed");
     }
 }
 
 void process_data_record(
-    std::optional<jsolve::Model>& model, const section& section, const std::vector<std::string>& words
+    std::optional<jsolve::Model>& model, const section& section, const std::vector<std::string_view>& words
 )
 {
     if (section == section::ROWS)
     {
         process_rows_data_record(model.value(), words);
     }
-    else if (section == section::COLUMNS)
-    {
-        process_cols_data_record(model.value(), words);
-    }
     else if (section == section::RHS)
     {
         process_rhs_data_record(model.value(), words);
@@ -345,9 +546,25 @@ void process_data_record(
     }
 }
 
-void process_record(std::optional<jsolve::Model>& model, section& section, const std::string& line)
+void process_record(
+    std::optional<jsolve::Model>& model,
+    section& section,
+    std::string_view line,
+    std::vector<std::string_view>& words
+)
 {
-    auto words = split_string(line);
+    if (line.starts_with('*'))
+    {
+        // Comment line
+        return;
+    }
+
+    split_words(line, words);
+
+    if (words.empty())
+    {
+        return;
+    }
 
     if (is_indicator_record(line))
     {
@@ -360,65 +577,163 @@ void process_record(std::optional<jsolve::Model>& model, section& section, const
     }
 }
 
-std::size_t count_lines(std::filesystem::path path)
+struct ReadState
 {
-    std::ifstream file{path, std::ios::in | std::ios::binary};
+    // Where the reader is, carried from one block of text to the next
+    std::optional<jsolve::Model> model;
+    section current_section{section::NONE};
+    std::vector<std::string_view> words;
+    std::size_t n_read{0};
+    std::size_t n_total{0}; // Zero when the size of the text is not known, for compressed files
+    std::size_t last_print{0};
+};
+
+void log_progress(ReadState& state)
+{
+    // Every 10% of the text, or every 64 MB when its size is not known
+
+    constexpr std::size_t print_percent{10};
+    constexpr std::size_t print_bytes{std::size_t{1} << 26};
 
-    std::size_t line_count = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
+    const auto step = state.n_total > 0 ? std::max<std::size_t>(state.n_total / (100 / print_percent), 1) : print_bytes;
 
-    return line_count;
+    if (state.n_read < state.last_print + step)
+    {
+        return;
+    }
+
+    state.last_print += step;
+
+    if (state.n_total > 0)
+    {
+        log()->debug("{}%", (100 * state.n_read) / state.n_total);
+    }
+    else
+    {
+        log()->debug("{} MB", state.n_read >> 20);
+    }
 }
 
-jsolve::Model read_mps(std::filesystem::path path)
+void read_text(ReadState& state, std::string_view text)
 {
-    Timer timer{info_logger(), "Reading MPS file {}", path};
+    // Reads whole lines of MPS text. The COLUMNS records up to the next header are handed to read_columns_section
+    // together, and a COLUMNS section cut by the end of the text carries on at the start of the next.
 
-    std::optional<jsolve::Model> model;
+    std::size_t offset{0};
 
-    if (!std::filesystem::exists(path))
+    while (offset < text.size())
     {
-        throw MPSError(fmt::format("File does not exist: {}", path));
+        const auto begin = offset;
+
+        if (state.current_section == section::COLUMNS && !is_indicator_record(text.substr(offset)))
+        {
+            while (offset < text.size() && !is_indicator_record(text.substr(offset)))
+            {
+                next_line(text, offset);
+            }
+
+            read_columns_section(state.model.value(), text.substr(begin, offset - begin));
+        }
+        else
+        {
+            process_record(state.model, state.current_section, next_line(text, offset), state.words);
+        }
+
+        state.n_read += offset - begin;
+        log_progress(state);
     }
+}
 
-    std::ifstream file{path, std::ios::in | std::ios::binary};
+void read_compressed(ReadState& state, const std::filesystem::path& path, CompressedFile::Format format)
+{
+    // Blocks are read as they are decompressed, a line cut by the end of a block is carried into the next
 
-    if (file.is_open())
+    if (!CompressedFile::supported(format))
     {
-        auto line_count = count_lines(path);
-        log()->debug("File has {} lines", line_count);
+        throw MPSError(fmt::format("Compression format not supported by this build: {}", path));
+    }
+
+    CompressedFile file{path, format};
 
-        auto current_section = section::NONE;
+    auto next_block = [&](std::string& block) {
+        try
+        {
+            return file.next_block(block);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw MPSError(fmt::format("{}: {}", e.what(), path));
+        }
+    };
 
-        const std::size_t print_percent = 10;
-        std::size_t step = line_count / (100 / print_percent);
-        std::size_t next_print = step;
-        std::size_t current_line = 0;
+    std::string text;
+    std::string block;
 
-        std::string line;
-        while (getline(file, line))
+    while (next_block(block))
+    {
+        if (text.empty())
+        {
+            text.swap(block);
+        }
+        else
         {
-            log()->debug("|{}", line);
-            process_record(model, current_section, line);
+            text.append(block);
+        }
 
-            current_line++;
-            if (current_line >= next_print)
-            {
-                auto percent = (100 * current_line) / line_count;
-                next_print += step;
-                log()->debug("{}%", percent);
-            }
+        const auto end = text.rfind('\n');
+
+        if (end != std::string::npos)
+        {
+            read_text(state, std::string_view{text}.substr(0, end + 1));
+            text.erase(0, end + 1);
         }
     }
+
+    read_text(state, text);
+}
+
+jsolve::Model read_mps(std::filesystem::path path)
+{
+    // The file is mapped and read in one pass, each line split into views of the mapped bytes.
+    // Files compressed with gzip or bzip2, found by their first bytes, are read in blocks as they are decompressed.
+    Timer timer{info_logger(), "Reading MPS file {}", path};
+
+    if (!std::filesystem::exists(path))
+    {
+        throw MPSError(fmt::format("File does not exist: {}", path));
+    }
+
+    ReadState state;
+
+    if (auto format = CompressedFile::detect(path))
+    {
+        read_compressed(state, path, format.value());
+    }
     else
     {
-        throw MPSError(fmt::format("File could not be opened: {}", path));
+        std::optional<MappedFile> file;
+
+        try
+        {
+            file.emplace(path);
+        }
+        catch (const std::system_error&)
+        {
+            throw MPSError(fmt::format("File could not be opened: {}", path));
+        }
+
+        const auto text = file->view();
+        log()->debug("File has {} bytes", text.size());
+
+        state.n_total = text.size();
+        read_text(state, text);
     }
 
-    if (!model)
+    if (!state.model)
     {
         throw MPSError("No model created");
     }
 
-    return std::move(model.value());
+    return std::move(state.model.value());
 }
 } // namespace jsolve
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "solve_error.h"
+
+#include <string>
+
+namespace jsolve
+{
+struct Options
+{
+    // User selectable settings for the solver.
+
+    enum class Pricing
+    {
+        DANTZIG, // Largest reduced cost
+        DEVEX    // Largest reduced cost relative to an approximate steepest edge weight
+    };
+
+    enum class Crash
+    {
+        NONE, // All slack basis
+        BIXBY // Triangular basis of structurals (Bixby, 1992)
+    };
+
+    Pricing primal_pricing{Pricing::DEVEX};
+    Crash crash{Crash::NONE};
+
+    // Reduce the model before solving, the removed variables are recovered afterwards. Off by default as postsolve
+    // only recovers primal values, so the solution has no duals or reduced costs when presolve changed the model.
+    bool presolve{false};
+
+    // Perturb bounds in the primal and costs in the dual to break degeneracy, removed again once optimal
+    bool perturbation{true};
+};
+
+inline Options::Pricing parse_pricing(const std::string& name)
+{
+    if (name == "dantzig")
+    {
+        return Options::Pricing::DANTZIG;
+    }
+    else if (name == "devex")
+    {
+        return Options::Pricing::DEVEX;
+    }
+
+    throw SolveError("Unknown pricing method: " + name);
+}
+
+inline Options::Crash parse_crash(const std::string& name)
+{
+    if (name == "none")
+    {
+        return Options::Crash::NONE;
+    }
+    else if (name == "bixby")
+    {
+        return Options::Crash::BIXBY;
+    }
+
+    throw SolveError("Unknown crash method: " + name);
+}
+} // namespace jsolve
@@ -0,0 +1,984 @@
+#include "presolve.h"
+
+#include "logging.h"
+#include "tools.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace jsolve
+{
+namespace
+{
+constexpr double infinity{std::numeric_limits<double>::infinity()};
+constexpr double feas_tolerance{1e-9};  // Relative tolerance on bounds and right hand sides
+constexpr double zero_tolerance{1e-12}; // Entries created by substitution below this are dropped
+constexpr double min_tightening{1e-3};  // Bounds are only tightened by more than this, relative to their size
+constexpr double max_implied{1e8};      // Implied bounds larger than this are not used
+
+// Constraints a variable is in, sorted by id so that they are visited in the same order on every run
+using Column = std::vector<Constraint*>;
+
+struct PresolveData
+{
+    Model& model;
+    PostsolveStack& stack;
+    std::unordered_map<Variable*, Column> columns{}; // Only looked up, so its own order does not matter
+    std::size_t n_rows_removed{0};
+    std::size_t n_cols_removed{0};
+};
+
+struct Activity
+{
+    double min{0.0};
+    double max{0.0};
+};
+
+double tolerance(double value)
+{
+    return feas_tolerance * (1.0 + std::abs(value));
+}
+
+std::pair<double, double> sides_of(const Constraint& constraint)
+{
+    // Lower and upper limits on the constraint lhs.
+
+    switch (constraint.type())
+    {
+    case Constraint::Type::LESS:
+        return {constraint.rhs() - constraint.range(), constraint.rhs()};
+    case Constraint::Type::GREAT:
+        return {constraint.rhs(), constraint.rhs() + constraint.range()};
+    case Constraint::Type::EQUAL:
+        return {constraint.rhs(), constraint.rhs()};
+    }
+
+    throw ModelError("Invalid constraint type");
+}
+
+void set_sides(Constraint& constraint, double lower, double upper)
+{
+    // Set the limits on the constraint lhs, as a ranged row if both are finite and apart.
+
+    constraint.range() = infinity;
+
+    if (lower == -infinity)
+    {
+        constraint.type() = Constraint::Type::LESS;
+        constraint.rhs() = upper;
+    }
+    else if (upper == infinity)
+    {
+        constraint.type() = Constraint::Type::GREAT;
+        constraint.rhs() = lower;
+    }
+    else if (upper - lower <= tolerance(upper))
+    {
+        constraint.type() = Constraint::Type::EQUAL;
+        constraint.rhs() = lower;
+    }
+    else
+    {
+        constraint.type() = Constraint::Type::LESS;
+        constraint.rhs() = upper;
+        constraint.range() = upper - lower;
+    }
+}
+
+Activity row_activity(const Constraint& constraint, const Variable* skip = nullptr)
+{
+    // Smallest and largest values of the constraint lhs over the variable bounds, leaving out skip.
+
+    Activity activity;
+
+    for (const auto& [variable, coeff] : constraint.entries())
+    {
+        if (variable == skip)
+        {
+            continue;
+        }
+
+        const auto lower = coeff * variable->lower_bound();
+        const auto upper = coeff * variable->upper_bound();
+
+        activity.min += std::min(lower, upper);
+        activity.max += std::max(lower, upper);
+    }
+
+    return activity;
+}
+
+void insert_row(Column& column, Constraint* constraint)
+{
+    auto it = std::ranges::lower_bound(column, constraint, Constraint::CompareIds{});
+    if (it == std::end(column) || *it != constraint)
+    {
+        column.insert(it, constraint);
+    }
+}
+
+void erase_row(Column& column, Constraint* constraint)
+{
+    auto it = std::ranges::lower_bound(column, constraint, Constraint::CompareIds{});
+    if (it != std::end(column) && *it == constraint)
+    {
+        column.erase(it);
+    }
+}
+
+void remove_row(PresolveData& data, Constraint* constraint)
+{
+    for (const auto& [variable, _] : constraint->entries())
+    {
+        erase_row(data.columns.at(variable), constraint);
+    }
+
+    const auto name = constraint->name();
+    data.n_rows_removed++;
+    data.model.remove_constraint(name);
+}
+
+void remove_col(PresolveData& data, Variable* variable)
+{
+    const auto constraints = data.columns.at(variable);
+    const auto name = variable->name();
+
+    data.columns.erase(variable);
+    data.n_cols_removed++;
+    data.model.remove_variable(name, constraints);
+}
+
+void fix_col(PresolveData& data, Variable* variable, double value, Reduction::Type type)
+{
+    // Remove a variable at a known value, moving its contribution to the rhs and objective constant.
+
+    for (auto* constraint : data.columns.at(variable))
+    {
+        constraint->rhs() -= constraint->entries().at(variable) * value;
+    }
+
+    data.model.constant() += variable->cost() * value;
+    data.stack.push_back({type, variable->name(), value});
+    remove_col(data, variable);
+}
+
+void substitute_col(PresolveData& data, Variable* variable, Constraint* constraint, Reduction::Type type)
+{
+    // Eliminate a variable with an equality it is in, a x + sum(a_k x_k) = b gives x = (b - sum(a_k x_k)) / a.
+    // This is substituted into the objective and the other constraints, then the equality and variable are removed.
+    // The caller makes sure the bounds on x are implied by the remaining model.
+
+    const auto a = constraint->entries().at(variable);
+    const auto b = constraint->rhs();
+
+    Reduction reduction{type, variable->name(), b, a};
+
+    for (const auto& [other, coeff] : constraint->entries())
+    {
+        if (other != variable)
+        {
+            reduction.entries.emplace_back(other->name(), coeff);
+        }
+    }
+
+    if (const auto cost = variable->cost(); cost != 0.0)
+    {
+        data.model.constant() += cost * b / a;
+
+        for (const auto& [other, coeff] : constraint->entries())
+        {
+            if (other != variable)
+            {
+                other->cost() -= cost * coeff / a;
+            }
+        }
+    }
+
+    for (auto* row : data.columns.at(variable))
+    {
+        if (row == constraint)
+        {
+            continue;
+        }
+
+        const auto ratio = row->entries().at(variable) / a;
+        row->rhs() -= ratio * b;
+
+        for (const auto& [other, coeff] : constraint->entries())
+        {
+            if (other == variable)
+            {
+                continue;
+            }
+
+            auto& entry = row->entries()[other];
+            entry -= ratio * coeff;
+
+            if (std::abs(entry) <= zero_tolerance)
+            {
+                row->entries().erase(other);
+                erase_row(data.columns.at(other), row);
+            }
+            else
+            {
+                insert_row(data.columns.at(other), row);
+            }
+        }
+    }
+
+    data.stack.push_back(std::move(reduction));
+    remove_row(data, constraint);
+    remove_col(data, variable);
+}
+
+bool tighten_bounds(Variable* variable, double lower, double upper)
+{
+    // Intersect the variable bounds with [lower, upper], returns false if they cross.
+
+    auto& l = variable->lower_bound();
+    auto& u = variable->upper_bound();
+
+    l = std::max(l, lower);
+    u = std::min(u, upper);
+
+    if (l > u)
+    {
+        if (l - u > tolerance(u))
+        {
+            return false;
+        }
+        u = l;
+    }
+
+    return true;
+}
+
+PresolveStatus presolve_row(PresolveData& data, Constraint* constraint)
+{
+    // Empty rows, row singletons, redundant and forcing rows, and doubleton equations.
+
+    const auto [lower, upper] = sides_of(*constraint);
+    const auto& entries = constraint->entries();
+
+    if (entries.empty())
+    {
+        if (lower > tolerance(lower) || upper < -tolerance(upper))
+        {
+            return PresolveStatus::INFEASIBLE;
+        }
+
+        data.stack.push_back({Reduction::Type::EMPTY_ROW, constraint->name()});
+        remove_row(data, constraint);
+        return PresolveStatus::REDUCED;
+    }
+
+    if (entries.size() == 1)
+    {
+        // l <= a x <= u bounds x by l / a and u / a, swapped for negative a
+        auto [variable, coeff] = *std::begin(entries);
+        auto lower_bound = lower / coeff;
+        auto upper_bound = upper / coeff;
+
+        if (coeff < 0)
+        {
+            std::swap(lower_bound, upper_bound);
+        }
+
+        if (!tighten_bounds(variable, lower_bound, upper_bound))
+        {
+            return PresolveStatus::INFEASIBLE;
+        }
+
+        data.stack.push_back({Reduction::Type::ROW_SINGLETON, constraint->name()});
+        remove_row(data, constraint);
+        return PresolveStatus::REDUCED;
+    }
+
+    const auto activity = row_activity(*constraint);
+
+    if (activity.min > upper + tolerance(upper) || activity.max < lower - tolerance(lower))
+    {
+        return PresolveStatus::INFEASIBLE;
+    }
+
+    if (lower != upper && activity.min >= lower - tolerance(lower) && activity.max <= upper + tolerance(upper))
+    {
+        data.stack.push_back({Reduction::Type::REDUNDANT_ROW, constraint->name()});
+        remove_row(data, constraint);
+        return PresolveStatus::REDUCED;
+    }
+
+    const bool forcing_min = upper < infinity && activity.min >= upper - tolerance(upper);
+    const bool forcing_max = lower > -infinity && activity.max <= lower + tolerance(lower);
+
+    if (forcing_min || forcing_max)
+    {
+        // Every variable sits at the bound that gives the min (or max) activity
+        for (const auto& [variable, coeff] : entries)
+        {
+            const auto value = (coeff > 0) == forcing_min ? variable->lower_bound() : variable->upper_bound();
+            variable->lower_bound() = value;
+            variable->upper_bound() = value;
+        }
+
+        data.stack.push_back({Reduction::Type::FORCING_ROW, constraint->name()});
+        remove_row(data, constraint);
+        return PresolveStatus::REDUCED;
+    }
+
+    if (constraint->type() == Constraint::Type::EQUAL && entries.size() == 2)
+    {
+        auto* x = std::begin(entries)->first;
+        auto* y = std::next(std::begin(entries))->first;
+        auto a_x = std::begin(entries)->second;
+        auto a_y = std::next(std::begin(entries))->second;
+
+        if (x->lower_bound() == x->upper_bound() || y->lower_bound() == y->upper_bound())
+        {
+            return PresolveStatus::REDUCED;
+        }
+
+        // Eliminate the variable in fewer constraints, unless its coefficient is much smaller
+        if (data.columns.at(y).size() > data.columns.at(x).size())
+        {
+            std::swap(x, y);
+            std::swap(a_x, a_y);
+        }
+        if (std::abs(a_y) < 0.1 * std::abs(a_x))
+        {
+            std::swap(x, y);
+            std::swap(a_x, a_y);
+        }
+
+        // The bounds on y become bounds on x = (b - a_y y) / a_x, recorded like those tightened by propagation
+        const auto x_1 = (lower - a_y * y->lower_bound()) / a_x;
+        const auto x_2 = (lower - a_y * y->upper_bound()) / a_x;
+        const auto x_lower = std::min(x_1, x_2);
+        const auto x_upper = std::max(x_1, x_2);
+
+        if (x_lower > x->lower_bound() || x_upper < x->upper_bound())
+        {
+            data.stack.push_back(
+                {Reduction::Type::TIGHTENED_BOUNDS, x->name(), 0.0, 1.0, {}, {x->lower_bound(), x->upper_bound()}}
+            );
+        }
+
+        if (!tighten_bounds(x, x_lower, x_upper))
+        {
+            return PresolveStatus::INFEASIBLE;
+        }
+
+        substitute_col(data, y, constraint, Reduction::Type::DOUBLETON);
+    }
+
+    return PresolveStatus::REDUCED;
+}
+
+PresolveStatus presolve_col(PresolveData& data, Variable* variable)
+{
+    // Empty columns, fixed columns and free (or implied free) column singletons in equalities.
+
+    const auto lower = variable->lower_bound();
+    const auto upper = variable->upper_bound();
+
+    if (lower > upper + tolerance(upper))
+    {
+        return PresolveStatus::INFEASIBLE;
+    }
+
+    const auto& rows = data.columns.at(variable);
+
+    if (rows.empty())
+    {
+        // Best bound for the objective, any finite value when the cost is zero
+        const auto cost = data.model.sense() == Model::Sense::MIN ? variable->cost() : -variable->cost();
+
+        auto value = lower > -infinity ? lower : (upper < infinity ? upper : 0.0);
+        if (cost > 0)
+        {
+            value = lower;
+        }
+        else if (cost < 0)
+        {
+            value = upper;
+        }
+
+        if (std::isinf(value))
+        {
+            return PresolveStatus::UNBOUNDED;
+        }
+
+        fix_col(data, variable, value, Reduction::Type::EMPTY_COL);
+        return PresolveStatus::REDUCED;
+    }
+
+    if (lower == upper)
+    {
+        fix_col(data, variable, lower, Reduction::Type::FIXED_COL);
+        return PresolveStatus::REDUCED;
+    }
+
+    if (rows.size() == 1)
+    {
+        auto* constraint = *std::begin(rows);
+
+        if (constraint->type() != Constraint::Type::EQUAL)
+        {
+            return PresolveStatus::REDUCED;
+        }
+
+        // The rest of the equality bounds x = (b - sum(a_k x_k)) / a, if within its own bounds x is implied free
+        const auto a = constraint->entries().at(variable);
+        const auto activity = row_activity(*constraint, variable);
+        const auto x_1 = (constraint->rhs() - activity.max) / a;
+        const auto x_2 = (constraint->rhs() - activity.min) / a;
+
+        if (std::min(x_1, x_2) >= lower - tolerance(lower) && std::max(x_1, x_2) <= upper + tolerance(upper))
+        {
+            substitute_col(data, variable, constraint, Reduction::Type::FREE_COL_SINGLETON);
+        }
+    }
+
+    return PresolveStatus::REDUCED;
+}
+
+template <typename Items>
+std::vector<std::string> names_of(const Items& items)
+{
+    std::vector<std::string> names;
+    names.reserve(items.size());
+
+    for (const auto& item : items)
+    {
+        names.push_back(item->name());
+    }
+
+    return names;
+}
+
+using Pattern = std::vector<std::pair<std::uint64_t, double>>; // Ids and values of a row or column, in id order
+
+std::size_t hash_pattern(const Pattern& pattern)
+{
+    // Hash of the ids and the values relative to the first, in single precision so nearby values agree.
+
+    auto combine = [](std::size_t& seed, std::size_t hash) { seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+
+    std::size_t seed{pattern.size()};
+
+    for (const auto& [id, value] : pattern)
+    {
+        combine(seed, std::hash<std::uint64_t>{}(id));
+        combine(seed, std::hash<float>{}(static_cast<float>(value / pattern.front().second)));
+    }
+
+    return seed;
+}
+
+std::optional<double> ratio_of(const Pattern& lhs, const Pattern& rhs)
+{
+    // The multiple r with rhs = r * lhs, if there is one.
+
+    if (lhs.size() != rhs.size())
+    {
+        return std::nullopt;
+    }
+
+    const auto ratio = rhs.front().second / lhs.front().second;
+
+    for (std::size_t pos{0}; pos < lhs.size(); pos++)
+    {
+        if (lhs[pos].first != rhs[pos].first ||
+            std::abs(rhs[pos].second - ratio * lhs[pos].second) > feas_tolerance * std::abs(rhs[pos].second))
+        {
+            return std::nullopt;
+        }
+    }
+
+    return ratio;
+}
+
+struct RowActivity
+{
+    // Finite parts of the min and max activity of a row, and how many variables add an infinite part to each
+    double min{0.0};
+    double max{0.0};
+    int n_min_inf{0};
+    int n_max_inf{0};
+};
+
+std::pair<double, double> contribution(double coeff, const Variable& variable)
+{
+    // Smallest and largest values of coeff * x over the bounds of x.
+
+    const auto lower = coeff * variable.lower_bound();
+    const auto upper = coeff * variable.upper_bound();
+    return {std::min(lower, upper), std::max(lower, upper)};
+}
+
+void update_activity(RowActivity& activity, double coeff, const Variable& variable, int sign)
+{
+    // Add (sign 1) or remove (sign -1) the contribution of a variable.
+
+    const auto [min, max] = contribution(coeff, variable);
+
+    if (std::isinf(min))
+    {
+        activity.n_min_inf += sign;
+    }
+    else
+    {
+        activity.min += sign * min;
+    }
+
+    if (std::isinf(max))
+    {
+        activity.n_max_inf += sign;
+    }
+    else
+    {
+        activity.max += sign * max;
+    }
+}
+
+std::size_t propagate_bounds(PresolveData& data)
+{
+    // Tighten variable bounds with the bounds implied by each row, a_j x_j <= u - (min activity of the rest of the
+    // row) and a_j x_j >= l - (max activity of the rest), "Presolving in linear programming" (Andersen & Andersen,
+    // 1995). Row activities are kept up to date as bounds change, and only rows with a changed variable are looked
+    // at again. A bound is only tightened by a clear margin, so slowly converging chains stop.
+    // Crossing bounds are left for the row and column passes to report, as they recompute activities exactly.
+    // Rows are held by their index in the model, and rows queued again go on in the id order of the columns, so the
+    // bounds tightened within the work limit are the same on every run.
+    // Returns the number of bounds tightened.
+
+    const auto& constraints = data.model.get_constraints();
+    const auto n_rows = constraints.size();
+
+    std::unordered_map<const Constraint*, std::size_t> indices;
+    indices.reserve(n_rows);
+
+    std::vector<RowActivity> activities(n_rows);
+    std::vector<std::size_t> queue;
+    queue.reserve(n_rows);
+    std::vector<bool> queued(n_rows, true);
+
+    for (std::size_t row = 0; row < n_rows; row++)
+    {
+        indices.emplace(constraints[row].get(), row);
+
+        for (const auto& [variable, coeff] : constraints[row]->entries())
+        {
+            update_activity(activities[row], coeff, *variable, 1);
+        }
+
+        queue.push_back(row);
+    }
+
+    // Propagation can go on for a long time through long chains of rows, so the entries looked at per call are
+    // limited to a number of passes over the matrix
+    constexpr std::size_t max_passes{20};
+
+    std::size_t max_work{0};
+    for (const auto& [_, rows] : data.columns)
+    {
+        max_work += max_passes * rows.size();
+    }
+
+    std::size_t work{0};
+    std::size_t n_tightened{0};
+
+    while (!queue.empty() && work < max_work)
+    {
+        const auto current = queue.back();
+        queue.pop_back();
+        queued[current] = false;
+
+        const auto* constraint = constraints[current].get();
+        const auto [lower_side, upper_side] = sides_of(*constraint);
+        const auto& activity = activities[current];
+
+        // Nothing is implied when each side has no bound or more than one infinite contribution
+        if ((upper_side == infinity || activity.n_min_inf > 1) && (lower_side == -infinity || activity.n_max_inf > 1))
+        {
+            continue;
+        }
+
+        work += constraint->entries().size();
+
+        for (const auto& [variable, coeff] : constraint->entries())
+        {
+            const auto [min, max] = contribution(coeff, *variable);
+
+            // Activity of the rest of the row, infinite if any other variable has an infinite contribution
+            const auto rest_min = std::isinf(min) ? (activity.n_min_inf == 1 ? activity.min : -infinity)
+                                                  : (activity.n_min_inf == 0 ? activity.min - min : -infinity);
+            const auto rest_max = std::isinf(max) ? (activity.n_max_inf == 1 ? activity.max : infinity)
+                                                  : (activity.n_max_inf == 0 ? activity.max - max : infinity);
+
+            auto lower = variable->lower_bound();
+            auto upper = variable->upper_bound();
+
+            auto tighten = [&](double bound, bool is_upper) {
+                if (std::abs(bound) > max_implied)
+                {
+                    return;
+                }
+
+                const auto margin = min_tightening * (1.0 + std::abs(bound));
+
+                if (is_upper && bound < upper - margin)
+                {
+                    upper = bound;
+                }
+                else if (!is_upper && bound > lower + margin)
+                {
+                    lower = bound;
+                }
+            };
+
+            if (upper_side < infinity && rest_min > -infinity)
+            {
+                tighten((upper_side - rest_min) / coeff, coeff > 0);
+            }
+
+            if (lower_side > -infinity && rest_max < infinity)
+            {
+                tighten((lower_side - rest_max) / coeff, coeff < 0);
+            }
+
+            if ((lower == variable->lower_bound() && upper == variable->upper_bound()) ||
+                lower > upper + tolerance(upper))
+            {
+                continue;
+            }
+
+            for (auto* row : data.columns.at(variable))
+            {
+                update_activity(activities[indices.at(row)], row->entries().at(variable), *variable, -1);
+            }
+
+            data.stack.push_back(
+                {Reduction::Type::TIGHTENED_BOUNDS,
+                 variable->name(),
+                 0.0,
+                 1.0,
+                 {},
+                 {variable->lower_bound(), variable->upper_bound()}}
+            );
+
+            variable->lower_bound() = lower;
+            variable->upper_bound() = std::max(lower, upper);
+
+            for (auto* row : data.columns.at(variable))
+            {
+                const auto index = indices.at(row);
+                update_activity(activities[index], row->entries().at(variable), *variable, 1);
+
+                if (!queued[index])
+                {
+                    queued[index] = true;
+                    queue.push_back(index);
+                }
+            }
+
+            n_tightened++;
+        }
+    }
+
+    return n_tightened;
+}
+
+PresolveStatus remove_parallel_rows(PresolveData& data)
+{
+    // Rows that are a multiple of an earlier row, found by hashing, are merged into it by intersecting their sides.
+    // Sides that intersect in a range make the kept row a ranged row.
+    // Singletons are left for the row pass.
+
+    std::unordered_map<std::size_t, std::vector<std::pair<Constraint*, Pattern>>> buckets;
+
+    for (const auto& name : names_of(data.model.get_constraints()))
+    {
+        auto* constraint = data.model.get_constraint(name);
+
+        if (constraint->entries().size() < 2)
+        {
+            continue;
+        }
+
+        Pattern pattern;
+        pattern.reserve(constraint->entries().size());
+
+        for (const auto& [variable, coeff] : constraint->entries())
+        {
+            pattern.emplace_back(variable->id(), coeff);
+        }
+
+        auto& bucket = buckets[hash_pattern(pattern)];
+        bool merged{false};
+
+        for (const auto& [kept, kept_pattern] : bucket)
+        {
+            auto ratio = ratio_of(kept_pattern, pattern);
+            if (!ratio)
+            {
+                continue;
+            }
+
+            // Sides in terms of the kept row, r * a x in [l, u] is a x in [l / r, u / r] (swapped for negative r)
+            auto [lower, upper] = sides_of(*constraint);
+            lower /= ratio.value();
+            upper /= ratio.value();
+            if (ratio.value() < 0)
+            {
+                std::swap(lower, upper);
+            }
+
+            const auto [kept_lower, kept_upper] = sides_of(*kept);
+            lower = std::max(lower, kept_lower);
+            upper = std::min(upper, kept_upper);
+
+            if (lower > upper + tolerance(upper))
+            {
+                return PresolveStatus::INFEASIBLE;
+            }
+
+            set_sides(*kept, lower, upper);
+            merged = true;
+            break;
+        }
+
+        if (merged)
+        {
+            data.stack.push_back({Reduction::Type::PARALLEL_ROW, name});
+            remove_row(data, constraint);
+        }
+        else
+        {
+            bucket.emplace_back(constraint, std::move(pattern));
+        }
+    }
+
+    return PresolveStatus::REDUCED;
+}
+
+PresolveStatus remove_duplicate_cols(PresolveData& data)
+{
+    // Columns that are a multiple r of an earlier column, with r times its cost, are merged into it.
+    // x_kept + r * x takes the place of x_kept, with bounds from both.
+
+    std::unordered_map<std::size_t, std::vector<std::pair<Variable*, Pattern>>> buckets;
+
+    for (const auto& name : names_of(data.model.get_variables()))
+    {
+        auto* variable = data.model.get_variable(name);
+        const auto& rows = data.columns.at(variable);
+
+        if (rows.empty())
+        {
+            continue;
+        }
+
+        Pattern pattern;
+        pattern.reserve(rows.size());
+
+        for (auto* constraint : rows)
+        {
+            pattern.emplace_back(constraint->id(), constraint->entries().at(variable));
+        }
+
+        auto& bucket = buckets[hash_pattern(pattern)];
+        bool merged{false};
+
+        for (const auto& [kept, kept_pattern] : bucket)
+        {
+            auto ratio = ratio_of(kept_pattern, pattern);
+            if (!ratio || std::abs(variable->cost() - ratio.value() * kept->cost()) > tolerance(variable->cost()))
+            {
+                continue;
+            }
+
+            const auto r = ratio.value();
+            const auto l = variable->lower_bound();
+            const auto u = variable->upper_bound();
+
+            data.stack.push_back(
+                {Reduction::Type::DUPLICATE_COL,
+                 name,
+                 0.0,
+                 r,
+                 {{kept->name(), r}},
+                 {kept->lower_bound(), kept->upper_bound(), l, u}}
+            );
+
+            kept->lower_bound() += std::min(r * l, r * u);
+            kept->upper_bound() += std::max(r * l, r * u);
+
+            merged = true;
+            break;
+        }
+
+        if (merged)
+        {
+            remove_col(data, variable);
+        }
+        else
+        {
+            bucket.emplace_back(variable, std::move(pattern));
+        }
+    }
+
+    return PresolveStatus::REDUCED;
+}
+} // namespace
+
+PresolveStatus presolve(Model& model, PostsolveStack& stack)
+{
+    // Reduce the model with passes over the constraints then the variables, until a pass makes no reductions.
+    // Based on "Presolving in linear programming" (Andersen & Andersen, 1995).
+
+    Timer timer{info_logger(), "Presolve"};
+
+    PresolveData data{model, stack};
+
+    for (const auto& variable : model.get_variables())
+    {
+        data.columns[variable.get()];
+    }
+
+    for (const auto& constraint : model.get_constraints())
+    {
+        constraint->entries().erase_if([](const auto& pair) { return pair.second == 0.0; });
+
+        for (const auto& [variable, _] : constraint->entries())
+        {
+            insert_row(data.columns.at(variable), constraint.get());
+        }
+    }
+
+    const auto n_rows = model.get_constraints().size();
+    const auto n_cols = model.get_variables().size();
+
+    std::size_t n_reductions{0};
+    std::size_t n_tightened{0};
+
+    do
+    {
+        n_tightened += propagate_bounds(data);
+        n_reductions = stack.size();
+
+        for (const auto& name : names_of(model.get_constraints()))
+        {
+            if (auto* constraint = model.get_constraint(name))
+            {
+                if (auto status = presolve_row(data, constraint); status != PresolveStatus::REDUCED)
+                {
+                    return status;
+                }
+            }
+        }
+
+        for (const auto& name : names_of(model.get_variables()))
+        {
+            if (auto* variable = model.get_variable(name))
+            {
+                if (auto status = presolve_col(data, variable); status != PresolveStatus::REDUCED)
+                {
+                    return status;
+                }
+            }
+        }
+
+        if (auto status = remove_parallel_rows(data); status != PresolveStatus::REDUCED)
+        {
+            return status;
+        }
+
+        if (auto status = remove_duplicate_cols(data); status != PresolveStatus::REDUCED)
+        {
+            return status;
+        }
+    } while (stack.size() != n_reductions);
+
+    log()->info(
+        "Presolve removed {} of {} constraints and {} of {} variables, and tightened {} bounds", data.n_rows_removed,
+        n_rows, data.n_cols_removed, n_cols, n_tightened
+    );
+
+    return PresolveStatus::REDUCED;
+}
+
+void postsolve(const PostsolveStack& stack, Solution& solution)
+{
+    // Recover the removed variables, latest reduction first so each only depends on values already known.
+    // Reductions name their variables, which are found in the solution through its variables' own names.
+
+    if (stack.empty())
+    {
+        return;
+    }
+
+    std::unordered_map<std::string_view, std::size_t> positions;
+    positions.reserve(solution.variables.size());
+    for (std::size_t n_var = 0; n_var < solution.variables.size(); n_var++)
+    {
+        positions.emplace(solution.variables[n_var]->name(), n_var);
+    }
+
+    auto value_of = [&](const std::string& name) -> double& { return solution.primal[positions.at(name)]; };
+
+    for (auto it = std::rbegin(stack); it != std::rend(stack); ++it)
+    {
+        switch (it->type)
+        {
+        case Reduction::Type::EMPTY_ROW:
+        case Reduction::Type::REDUNDANT_ROW:
+        case Reduction::Type::ROW_SINGLETON:
+        case Reduction::Type::FORCING_ROW:
+        case Reduction::Type::PARALLEL_ROW:
+        case Reduction::Type::TIGHTENED_BOUNDS:
+            break;
+        case Reduction::Type::EMPTY_COL:
+        case Reduction::Type::FIXED_COL:
+        case Reduction::Type::FREE_COL_SINGLETON:
+        case Reduction::Type::DOUBLETON:
+        {
+            auto value = it->value;
+            for (const auto& [name, coeff] : it->entries)
+            {
+                value -= coeff * value_of(name);
+            }
+            value_of(it->name) = value / it->coeff;
+            break;
+        }
+        case Reduction::Type::DUPLICATE_COL:
+        {
+            // Split x_kept + r * x within both sets of bounds, with x at a bound where possible
+            const auto& kept = it->entries.front().first;
+            const auto ratio = it->coeff;
+            const auto merged = value_of(kept);
+
+            auto lower = (merged - it->bounds[1]) / ratio;
+            auto upper = (merged - it->bounds[0]) / ratio;
+            if (ratio < 0)
+            {
+                std::swap(lower, upper);
+            }
+            lower = std::max(lower, it->bounds[2]);
+            upper = std::min(upper, it->bounds[3]);
+
+            const auto value = lower > -infinity ? lower : (upper < infinity ? upper : 0.0);
+            value_of(it->name) = value;
+            value_of(kept) = merged - ratio * value;
+            break;
+        }
+        }
+    }
+}
+} // namespace jsolve
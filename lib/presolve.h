@@ -0,0 +1,58 @@
+#pragma once
+
+#include "model.h"
+#include "solution.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jsolve
+{
+struct Reduction
+{
+    // One presolve reduction, undone by postsolve in reverse order.
+    // A removed variable is recovered from x = (value - sum(entries[k] * x_k)) / coeff, so a fixed variable has no
+    // entries and a coeff of 1. Removed constraints need nothing to recover the primal values.
+    // A duplicate column was merged into the single entry variable as x_kept + coeff * x, and is split again
+    // within the original bounds of both. Tightened bounds need nothing to recover the primal values, and are kept
+    // with the other reductions as the duals of the reduced model depend on them.
+
+    enum class Type
+    {
+        EMPTY_ROW,          // No entries
+        REDUNDANT_ROW,      // Satisfied for all values within the variable bounds
+        ROW_SINGLETON,      // One entry, replaced by a variable bound
+        FORCING_ROW,        // Only satisfied with every variable at one bound, which fixes them
+        EMPTY_COL,          // In no constraint, fixed at its best bound
+        FIXED_COL,          // Equal bounds
+        FREE_COL_SINGLETON, // In one equality only and (implied) free, substituted out with the equality
+        DOUBLETON,          // Substituted out with an equality of two variables
+        PARALLEL_ROW,       // Multiple of another row, merged into it
+        DUPLICATE_COL,      // Multiple of another column with the same multiple of cost, merged into it
+        TIGHTENED_BOUNDS    // Variable bounds tightened to the bounds implied by the rows
+    };
+
+    Type type{Type::EMPTY_ROW};
+    std::string name; // Removed constraint or variable
+    double value{0.0};
+    double coeff{1.0};
+    std::vector<std::pair<std::string, double>> entries{};
+    std::vector<double> bounds{}; // Kept then removed bounds of duplicate columns, or the bounds before tightening
+};
+
+using PostsolveStack = std::vector<Reduction>;
+
+enum class PresolveStatus
+{
+    REDUCED,
+    INFEASIBLE,
+    UNBOUNDED
+};
+
+// Reduce the model in place, recording each reduction on the stack
+PresolveStatus presolve(Model& model, PostsolveStack& stack);
+
+// Fill in the values of the variables removed by presolve, in a solution holding every variable of the original model
+void postsolve(const PostsolveStack& stack, Solution& solution);
+} // namespace jsolve
@@ -1,11 +1,12 @@
 #include "primal_revised.h"
+#include "options.h"
 #include "constraint.h"
 #include "simplex_common.h"
 
 #include "variable.h"
 
-#include "lu_factor.h"
 #include "solve_error.h"
+#include "sparse_lu.h"
 
 #include "matrix.h"
 #include "tools.h"
@@ -13,6 +14,13 @@
 #include "logging.h"
 
 #include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
 
 namespace jsolve
 {
@@ -20,70 +28,516 @@ namespace
 {
 struct Parameters
 {
-    int refactor_iter{50}; // Periodically recompute LU factorisation
-    int max_iter{10000};   // Stopping criteria - max simplex iterations
-    Number EPS1{1e-8};     // Minimum value to consider as exiting var
-    Number EPS2{1e-5};     // Protection from division by zero
+    int refactor_iter{100}; // Periodically recompute LU factorisation
+    int max_iter{10000};    // Stopping criteria - max simplex iterations, raised for large models
+    Number EPS1{1e-8};      // Minimum value to consider as exiting var
+    Number EPS2{1e-5};      // Protection from division by zero
+    Number EPS3{1e-6};      // Relative tolerance for the FTRAN and BTRAN pivots to agree
+    Number EPS4{1e-7};      // Dual infeasibility allowed by the dual ratio test
+    Number EPS5{1e-7};      // Primal infeasibility allowed by the primal ratio test
+    Number EPS6{1e-5};      // Relative size of the bound and cost perturbations
+    Number EPS7{1e-6};      // Unscaled primal and dual infeasibility allowed in the solution
+    Options::Pricing primal_pricing{Options::Pricing::DEVEX};
+    bool perturb{true};     // Perturb bounds (primal) and costs (dual) when stalling
+    int stall_iter{50};     // Consecutive degenerate iterations before perturbing
+    int max_cleanup{10};    // Passes removing shifts and unscaled infeasibility before giving up
+};
+
+constexpr Number infinity{std::numeric_limits<Number>::infinity()};
+
+struct Position
+{
+    // Where a variable sits in the basis header.
+    bool basic{false};
+    std::size_t slot{0}; // Row of the basis if basic, otherwise position in the non-basics
 };
 
 struct SolveData
 {
     // Everything needed to do iterations of the revised simplex algorithm.
     // Using notation from 'Linear Programming' (Vanderbei, 2020) p102.
-    Mat A;
+    // B and N are not stored, the basis header (basics, non_basics and positions) selects their columns from A.
+    // Variables have bounds lower <= x <= upper, and each non-basic sits at one of its bounds (or zero if free).
+    SparseMat A;
+    Mat b;
     Mat c;
-    Mat B;
-    Mat N;
     Mat x_basic;
+    Mat x_non_basic;
     Mat z_non_basic;
     std::vector<VarData> basics;
     std::vector<VarData> non_basics;
+    std::vector<Position> positions;   // Variable index -> location in basics or non_basics
+    std::vector<Number> lower;         // Variable index -> lower bound (scaled)
+    std::vector<Number> upper;         // Variable index -> upper bound (scaled)
+    std::vector<Number> dual_weights;  // Basis row -> dual steepest edge weight, ||row of inv(B)||^2
+    std::vector<Number> devex_weights; // Non-basic slot -> primal Devex reference weight
     int n_iter{0};
     std::vector<Number> row_scale_factors;
     std::vector<Number> col_scale_factors;
 };
 
-std::optional<std::size_t> choose_entering(const Mat& column, Number EPS2)
+struct Workspace
+{
+    // Sparse vectors reused by every iteration, sized to the rows of A once. FTRAN and BTRAN clear them through their
+    // lists of non-zeros, so an iteration only touches the entries it reaches.
+    explicit Workspace(std::size_t m) : column{m}, unit{m}, dx{m}, rho{m}, tau{m}, spike{m}, change{m}, flip_dx{m} {}
+
+    SparseVec column;  // Column of A entering the basis
+    SparseVec unit;    // e_i, the right-hand side of BTRAN
+    SparseVec dx;      // inv(B) * column
+    SparseVec rho;     // Row i of inv(B)
+    SparseVec tau;     // inv(B) * rho, for the dual steepest edge weights
+    SparseVec spike;   // Partially transformed column, for the LU update
+    SparseVec change;  // Sum of the flipped columns
+    SparseVec flip_dx; // inv(B) * change
+};
+
+Number lower_of(const SolveData& data, const VarData& var)
+{
+    return data.lower[static_cast<std::size_t>(var.index)];
+}
+
+Number upper_of(const SolveData& data, const VarData& var)
+{
+    return data.upper[static_cast<std::size_t>(var.index)];
+}
+
+Number primal_infeasibility(const SolveData& data, std::size_t row)
+{
+    // Signed bound violation of a basic variable, negative below its lower bound and positive above its upper.
+
+    const auto x = data.x_basic(row, 0);
+    const auto& var = data.basics[row];
+
+    if (x < lower_of(data, var))
+    {
+        return x - lower_of(data, var);
+    }
+    if (x > upper_of(data, var))
+    {
+        return x - upper_of(data, var);
+    }
+    return 0.0;
+}
+
+Number dual_infeasibility(const SolveData& data, std::size_t slot)
 {
-    // Choses most negative variable in the column vector.
+    // Signed dual violation of a non-basic variable, given the bound it sits at.
+    // At a lower bound z >= 0 is needed, at an upper bound z <= 0 and when free z = 0. Fixed variables
+    // never need to move so are always dual feasible.
+
+    const auto x = data.x_non_basic(slot, 0);
+    const auto z = data.z_non_basic(slot, 0);
+    const auto& var = data.non_basics[slot];
+
+    const bool at_lower = x == lower_of(data, var);
+    const bool at_upper = x == upper_of(data, var);
+
+    if (at_lower && at_upper)
+    {
+        return 0.0;
+    }
+    if (at_lower)
+    {
+        return std::min(z, 0.0);
+    }
+    if (at_upper)
+    {
+        return std::max(z, 0.0);
+    }
+    return z;
+}
+
+std::optional<std::size_t> choose_entering_primal(const SolveData& data, Number EPS2)
+{
+    // Choses the non-basic variable with the largest dual infeasibility relative to its pricing weight,
+    // i.e. max infeasibility^2 / weight. With every weight at one this is Dantzig's rule, extended to bounds.
 
     std::optional<std::size_t> entering;
-    Number current_min{-EPS2};
+    Number current_max{0.0};
 
-    for (std::size_t curr_idx = 0; curr_idx < column.n_rows(); curr_idx++)
+    for (std::size_t slot = 0; slot < data.non_basics.size(); slot++)
     {
-        if (column(curr_idx, 0) < current_min)
+        const auto infeasibility = std::abs(dual_infeasibility(data, slot));
+
+        if (infeasibility > EPS2)
         {
-            entering = curr_idx;
-            current_min = column(curr_idx, 0);
+            const auto merit = infeasibility * infeasibility / data.devex_weights[slot];
+
+            if (merit > current_max)
+            {
+                entering = slot;
+                current_max = merit;
+            }
         }
     }
 
     return entering;
 }
 
-std::optional<std::size_t> choose_leaving(const Mat& num, const Mat& denom, Number EPS1)
+std::optional<std::size_t> choose_entering_dual(const SolveData& data, Number EPS2)
 {
-    // Calculates argmin(num/denom), where denom > zero.
+    // Choses the basic variable with the largest primal infeasibility relative to its steepest edge weight,
+    // i.e. max infeasibility^2 / weight. It will leave the basis at the violated bound.
+    // Dual steepest edge, "Computational Techniques of the Simplex Method" (Maros, 2003) p250.
 
-    std::optional<std::size_t> leaving;
-    Mat::value_type min_ratio{std::numeric_limits<Mat::value_type>::max()};
+    std::optional<std::size_t> entering;
+    Number current_max{0.0};
 
-    for (std::size_t curr_idx = 0; curr_idx < num.n_rows(); curr_idx++)
+    for (std::size_t row = 0; row < data.basics.size(); row++)
     {
-        if (denom(curr_idx, 0) > EPS1)
+        const auto infeasibility = std::abs(primal_infeasibility(data, row));
+
+        if (infeasibility > EPS2)
         {
-            auto curr_ratio{num(curr_idx, 0) / denom(curr_idx, 0)};
+            const auto merit = infeasibility * infeasibility / data.dual_weights[row];
 
-            if (curr_ratio < min_ratio)
+            // An infeasible row is always chosen, even if its weight has grown so large the merit is zero
+            if (!entering || merit > current_max)
             {
-                min_ratio = curr_ratio;
-                leaving = curr_idx;
+                entering = row;
+                current_max = merit;
             }
         }
     }
 
-    return leaving;
+    return entering;
+}
+
+struct PrimalStep
+{
+    std::optional<std::size_t> leaving; // Basis row of the leaving variable, empty for a bound flip
+    Number theta{0};                    // Distance moved by the entering variable
+    bool to_upper{false};               // Leaving variable becomes non-basic at its upper bound
+};
+
+std::optional<PrimalStep> choose_leaving_primal(
+    const SolveData& data, const SparseVec& dx, Number direction, Number range, Parameters params
+)
+{
+    // Bounded ratio test, "Computational Techniques of the Simplex Method" (Maros, 2003) ch. 9.
+    // The entering variable moves by direction * theta, so basic i moves by -direction * theta * dx_i and
+    // is blocked by the bound it moves towards. The entering variable is blocked by its own opposite bound
+    // after range, giving a bound flip without a basis change.
+    // Uses two passes (Harris, 1973): find the largest step if each basic may pass its bound by EPS5, then
+    // choose the largest pivot within it. Ties keep the lowest row. Basics that pass their bound have it
+    // shifted afterwards, see shift_bound.
+    // Returns nothing if the step is unbounded.
+
+    auto blocking = [&](std::size_t row) {
+        // Pivot, distance to the blocking bound (negative if already past it) and whether it is the upper
+        const auto alpha = direction * dx[row];
+        const auto x = data.x_basic(row, 0);
+        const auto& var = data.basics[row];
+
+        if (alpha > params.EPS1 && lower_of(data, var) > -infinity)
+        {
+            return std::tuple{alpha, x - lower_of(data, var), false};
+        }
+        if (alpha < -params.EPS1 && upper_of(data, var) < infinity)
+        {
+            return std::tuple{-alpha, upper_of(data, var) - x, true};
+        }
+        return std::tuple{0.0, infinity, false};
+    };
+
+    Number max_step{infinity};
+    for (const auto row : dx.indices())
+    {
+        const auto [pivot, distance, to_upper] = blocking(row);
+        if (pivot != 0.0)
+        {
+            max_step = std::min(max_step, (std::max(distance, 0.0) + params.EPS5) / pivot);
+        }
+    }
+
+    if (range <= max_step)
+    {
+        // Bound flip, or unbounded if the range is infinite too
+        if (range == infinity)
+        {
+            return std::nullopt;
+        }
+        return PrimalStep{std::nullopt, range, false};
+    }
+
+    PrimalStep step{};
+    Number max_pivot{0.0};
+
+    for (const auto row : dx.indices())
+    {
+        const auto [pivot, distance, to_upper] = blocking(row);
+        if (pivot == 0.0)
+        {
+            continue;
+        }
+
+        const auto ratio = std::max(distance, 0.0) / pivot;
+        if (ratio <= max_step && (pivot > max_pivot || (pivot == max_pivot && row < step.leaving.value())))
+        {
+            max_pivot = pivot;
+            step = {row, ratio, to_upper};
+        }
+    }
+
+    return step;
+}
+
+Number dual_ratio_pivot(const SolveData& data, const Mat& dz, std::size_t slot, Number sign, Number EPS1)
+{
+    // Pivot d = sign * dz of a non-basic in the dual ratio test, or zero if it cannot enter.
+    // sign is +1 when the leaving variable goes to its lower bound and -1 for its upper bound.
+    // Each non-basic may only move away from the bound it sits at, and fixed variables never enter.
+
+    const auto d = sign * dz(slot, 0);
+    const auto x = data.x_non_basic(slot, 0);
+    const auto& var = data.non_basics[slot];
+
+    const bool at_lower = x == lower_of(data, var);
+    const bool at_upper = x == upper_of(data, var);
+
+    if (at_lower && at_upper)
+    {
+        return 0.0;
+    }
+    if ((at_lower && d > EPS1) || (at_upper && d < -EPS1) || (!at_lower && !at_upper && std::abs(d) > EPS1))
+    {
+        return d;
+    }
+    return 0.0;
+}
+
+struct DualStep
+{
+    std::optional<std::size_t> leaving; // Non-basic slot of the entering variable
+    std::vector<std::size_t> flips;     // Boxed non-basics passed over, these move to their opposite bound
+};
+
+DualStep choose_leaving_dual(const SolveData& data, const Mat& dz, Number sign, Number infeasibility, Parameters params)
+{
+    // Bound flipping (long step) dual ratio test, "Computational Techniques of the Simplex Method"
+    // (Maros, 2003) p185 and (Koberstein, 2005).
+    // The breakpoints z_j / d_j are passed in increasing order. The dual objective improves at a rate (slope)
+    // starting at the infeasibility of the leaving row. Passing a boxed variable flips it to its opposite
+    // bound, which reduces the slope by |d_j| * (u_j - l_j).
+    // Breakpoints are taken in groups using the bound from (Harris, 1973): the largest step if each z may go
+    // infeasible by EPS4. A group is passed while the slope stays positive, otherwise the largest pivot in
+    // the group is chosen, avoiding tiny pivots when degenerate.
+
+    struct Breakpoint
+    {
+        std::size_t slot;
+        Number pivot;
+        Number ratio;
+    };
+
+    std::vector<Breakpoint> breakpoints;
+
+    for (std::size_t slot = 0; slot < data.non_basics.size(); slot++)
+    {
+        const auto d = dual_ratio_pivot(data, dz, slot, sign, params.EPS1);
+
+        if (d != 0.0)
+        {
+            // z has the same sign as d when dual feasible, anything else is treated as zero
+            const auto z = std::max(d > 0.0 ? data.z_non_basic(slot, 0) : -data.z_non_basic(slot, 0), 0.0);
+            breakpoints.push_back({slot, std::abs(d), z / std::abs(d)});
+        }
+    }
+
+    std::ranges::sort(breakpoints, {}, &Breakpoint::ratio);
+
+    // Harris bound of the breakpoints from each position onwards
+    std::vector<Number> max_steps(breakpoints.size() + 1, infinity);
+    for (auto pos = breakpoints.size(); pos > 0; pos--)
+    {
+        const auto& point = breakpoints[pos - 1];
+        max_steps[pos - 1] = std::min(max_steps[pos], point.ratio + params.EPS4 / point.pivot);
+    }
+
+    DualStep step{};
+
+    auto slope = infeasibility;
+    std::size_t first{0};
+    while (first < breakpoints.size())
+    {
+        // The next group is the breakpoints within the Harris bound
+        auto last = first;
+        Number slope_change{0.0};
+        while (last < breakpoints.size() && breakpoints[last].ratio <= max_steps[first])
+        {
+            // Variables that are not boxed have an infinite range, so stop the step
+            const auto& var = data.non_basics[breakpoints[last].slot];
+            slope_change += breakpoints[last].pivot * (upper_of(data, var) - lower_of(data, var));
+            last++;
+        }
+
+        if (slope - slope_change <= params.EPS2)
+        {
+            // The row would be feasible within tolerance, stop here
+            // Choose the largest pivot in the group, ties go to the lowest slot
+            Number max_pivot{0.0};
+            for (auto pos = first; pos < last; pos++)
+            {
+                const auto& point = breakpoints[pos];
+                if (point.pivot > max_pivot || (point.pivot == max_pivot && point.slot < step.leaving.value()))
+                {
+                    max_pivot = point.pivot;
+                    step.leaving = point.slot;
+                }
+            }
+            return step;
+        }
+
+        // Pass the whole group, flipping each variable
+        slope -= slope_change;
+        for (auto pos = first; pos < last; pos++)
+        {
+            step.flips.push_back(breakpoints[pos].slot);
+        }
+        first = last;
+    }
+
+    // Dual unbounded
+    step.flips.clear();
+    return step;
+}
+
+void flip_bounds(SolveData& data, const SparseLU<Number>& lu, const std::vector<std::size_t>& flips, Workspace& work)
+{
+    // Move each listed non-basic to its opposite bound, and update x_basic with a single FTRAN:
+    // x_basic = x_basic - inv(B) * sum(a_j * change_j)
+
+    auto& change = work.change;
+    change.clear();
+
+    for (const auto slot : flips)
+    {
+        const auto& var = data.non_basics[slot];
+        auto& x = data.x_non_basic(slot, 0);
+
+        const auto new_x = x == lower_of(data, var) ? upper_of(data, var) : lower_of(data, var);
+        const auto delta = new_x - x;
+        x = new_x;
+
+        const auto col = static_cast<std::size_t>(var.index);
+        auto rows = data.A.col_indices(col);
+        auto values = data.A.col_values(col);
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
+        {
+            change.add(rows[pos], values[pos] * delta);
+        }
+    }
+
+    lu.solve(change, work.flip_dx);
+    const auto& dx = work.flip_dx;
+
+    for (const auto i : dx.indices())
+    {
+        data.x_basic(i, 0) -= dx[i];
+    }
+}
+
+void update_x_basic(Mat& x_basic, const SparseVec& dx, Number t)
+{
+    // x_basic = x_basic - t * dx, visiting only the non-zeros of dx.
+
+    for (const auto i : dx.indices())
+    {
+        x_basic(i, 0) -= t * dx[i];
+    }
+}
+
+void shift_bound(SolveData& data, std::size_t row)
+{
+    // Bound shifting for the primal Harris ratio test (Koberstein, 2005). A basic past its bound has the
+    // bound moved out to its value, so it can leave the basis there with a zero step.
+    // The original bounds are restored once optimal, see remove_bound_shifts.
+
+    const auto x = data.x_basic(row, 0);
+    const auto index = static_cast<std::size_t>(data.basics[row].index);
+
+    if (x < data.lower[index])
+    {
+        data.lower[index] = x;
+    }
+    else if (x > data.upper[index])
+    {
+        data.upper[index] = x;
+    }
+}
+
+void shift_cost(SolveData& data, std::size_t slot)
+{
+    // Cost shifting for the dual Harris ratio test (Koberstein, 2005). A non-basic left dual infeasible
+    // has its cost moved so that z = 0. As z = trans(a) * y - c this adds z to the cost.
+    // The original costs are restored once optimal.
+
+    if (dual_infeasibility(data, slot) != 0.0)
+    {
+        auto& z = data.z_non_basic(slot, 0);
+        data.c(data.non_basics[slot].index, 0) += z;
+        z = 0.0;
+    }
+}
+
+void perturb_bounds(SolveData& data, Parameters params)
+{
+    // Bound perturbation against primal degeneracy (Koberstein, 2005). The finite bounds of each basic are
+    // moved outwards by a small random amount relative to the bound, so that degenerate basics are no longer
+    // at a bound and the ratio test makes progress. The basis stays primal feasible.
+    // The perturbations are removed with the shifts once optimal, see remove_bound_shifts.
+
+    std::mt19937 generator{};
+    std::uniform_real_distribution<Number> random{0.0, 1.0};
+
+    for (const auto& var : data.basics)
+    {
+        const auto index = static_cast<std::size_t>(var.index);
+
+        if (data.lower[index] > -infinity)
+        {
+            data.lower[index] -= params.EPS6 * (1.0 + std::abs(data.lower[index])) * (1.0 + random(generator));
+        }
+        if (data.upper[index] < infinity)
+        {
+            data.upper[index] += params.EPS6 * (1.0 + std::abs(data.upper[index])) * (1.0 + random(generator));
+        }
+    }
+}
+
+void perturb_costs(SolveData& data, Parameters params)
+{
+    // Cost perturbation against dual degeneracy (Koberstein, 2005). The cost of each non-basic is changed by a
+    // small random amount relative to the cost, moving z further into its feasible side, so that ties in
+    // the dual ratio test are broken. Fixed and free non-basics are left alone.
+    // The perturbations are removed with the shifts once optimal.
+
+    std::mt19937 generator{};
+    std::uniform_real_distribution<Number> random{0.0, 1.0};
+
+    for (std::size_t slot{0}; const auto& var : data.non_basics)
+    {
+        const auto x = data.x_non_basic(slot, 0);
+        const bool at_lower = x == lower_of(data, var);
+        const bool at_upper = x == upper_of(data, var);
+
+        auto& c = data.c(var.index, 0);
+        const auto delta = params.EPS6 * (1.0 + std::abs(c)) * (1.0 + random(generator));
+
+        // z = trans(a) * y - c
+        if (at_lower && !at_upper)
+        {
+            c -= delta;
+            data.z_non_basic(slot, 0) += delta;
+        }
+        else if (at_upper && !at_lower)
+        {
+            c += delta;
+            data.z_non_basic(slot, 0) -= delta;
+        }
+        slot++;
+    }
 }
 
 Number calc_primal_obj(const SolveData& data)
@@ -95,6 +549,11 @@ Number calc_primal_obj(const SolveData& data)
         primal_obj += data.c(data.basics[curr_idx].index, 0) * data.x_basic(curr_idx, 0);
     }
 
+    for (std::size_t curr_idx = 0; curr_idx < data.x_non_basic.n_rows(); curr_idx++)
+    {
+        primal_obj += data.c(data.non_basics[curr_idx].index, 0) * data.x_non_basic(curr_idx, 0);
+    }
+
     return primal_obj;
 }
 
@@ -102,13 +561,19 @@ void log_iteration(int iter, const SolveData& data)
 {
     int log_every{1};
 
-    auto sum_if_negative = [](const auto& sum, const auto& current) {
-        return current < 0 ? sum + current : sum;
-    };
-
     auto primal_obj{calc_primal_obj(data)};
-    auto dual_infeas = std::accumulate(std::begin(data.z_non_basic), std::end(data.z_non_basic), 0.0, sum_if_negative);
-    auto primal_infeas = std::accumulate(std::begin(data.x_basic), std::end(data.x_basic), 0.0, sum_if_negative);
+
+    Number dual_infeas{0.0};
+    for (std::size_t slot = 0; slot < data.non_basics.size(); slot++)
+    {
+        dual_infeas -= std::abs(dual_infeasibility(data, slot));
+    }
+
+    Number primal_infeas{0.0};
+    for (std::size_t row = 0; row < data.basics.size(); row++)
+    {
+        primal_infeas -= std::abs(primal_infeasibility(data, row));
+    }
 
     std::string progress{fmt::format(
         "It {:6} Obj {:12.4f} DInf: {:12.4f} PInf: {:12.4f}", iter, primal_obj, dual_infeas, primal_infeas
@@ -124,63 +589,143 @@ void log_iteration(int iter, const SolveData& data)
     }
 }
 
-std::pair<std::vector<Number>, std::vector<Number>> scale_system(Mat& A, Mat& b, Mat& c)
+Number scaled_spread(const SparseMat& A, const std::vector<Number>& row_factors, const std::vector<Number>& col_factors)
 {
-    // Scale the model using equilibration scaling
-    // Described in "Computational Techniques of the Simplex Method" (Maros, 2003) p110
+    // Ratio of the largest to the smallest scaled non-zero magnitude, 1 when A is empty.
 
-    std::vector<Number> row_scale_factors;
+    Number min_abs{infinity};
+    Number max_abs{0.0};
 
-    // Row scaling
-    for (std::size_t i{0}; i < A.n_rows(); i++)
+    for (std::size_t j{0}; j < A.n_cols(); j++)
     {
-        Number row_abs_max{0};
+        auto rows = A.col_indices(j);
+        auto values = A.col_values(j);
 
-        for (std::size_t j{0}; j < A.n_cols(); j++)
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
         {
-            row_abs_max = std::max(row_abs_max, std::abs(A(i, j)));
+            const auto a = std::abs(values[pos]) * row_factors[rows[pos]] * col_factors[j];
+            if (a > 0.0)
+            {
+                min_abs = std::min(min_abs, a);
+                max_abs = std::max(max_abs, a);
+            }
         }
+    }
+
+    return max_abs > 0.0 ? max_abs / min_abs : 1.0;
+}
 
-        row_scale_factors.push_back(1.0 / row_abs_max);
+void update_scale_factors(const SparseMat& A,
+                          std::vector<Number>& row_factors,
+                          const std::vector<Number>& col_factors,
+                          bool by_row,
+                          bool geometric)
+{
+    // One pass over the rows (by_row) or cols of A, scaled by the current factors.
+    // Each row/col factor is updated so the scaled magnitudes have a geometric mean of 1 (sqrt of min * max)
+    // or, when not geometric, a largest magnitude of 1. Empty rows/cols keep their factor.
+    // The row/col roles are swapped by the caller for column passes. Rows/cols are independent, so run in parallel.
+
+    auto func = [&](std::size_t i) {
+        auto indices = by_row ? A.row_indices(i) : A.col_indices(i);
+        auto values = by_row ? A.row_values(i) : A.col_values(i);
+
+        Number min_abs{infinity};
+        Number max_abs{0.0};
+
+        for (std::size_t pos{0}; pos < indices.size(); pos++)
+        {
+            const auto a = std::abs(values[pos]) * row_factors[i] * col_factors[indices[pos]];
+            if (a > 0.0)
+            {
+                min_abs = std::min(min_abs, a);
+                max_abs = std::max(max_abs, a);
+            }
+        }
 
-        for (std::size_t j{0}; j < A.n_cols(); j++)
+        if (max_abs > 0.0)
         {
-            // A rows
-            A(i, j) = A(i, j) * row_scale_factors[i];
+            row_factors[i] /= geometric ? std::sqrt(min_abs * max_abs) : max_abs;
         }
+    };
 
-        // b rows
-        b(i, 0) = b(i, 0) * row_scale_factors[i];
+    std::vector<std::size_t> rows(row_factors.size());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    std::for_each(std::execution::par, rows.begin(), rows.end(), func);
+}
+
+void round_to_power_of_two(std::vector<Number>& factors)
+{
+    // Powers of two scale exactly, so scaling adds no rounding error to A, b, c or the solution.
+
+    for (auto& factor : factors)
+    {
+        factor = std::exp2(std::round(std::log2(factor)));
     }
+}
 
-    std::vector<Number> col_scale_factors;
+std::pair<std::vector<Number>, std::vector<Number>> scale_system(SparseMat& A, Mat& b, Mat& c)
+{
+    // Scale the model with geometric mean passes followed by equilibration,
+    // described in "Computational Techniques of the Simplex Method" (Maros, 2003) p110-113.
+    // Geometric passes alternate rows and cols until the spread of magnitudes stops improving by 10%.
+    // The final equilibration brings the largest magnitude in each row and col close to 1.
+    // Factors are rounded to powers of two, only the non-zeros of A are visited and A is scaled once at the end.
 
-    void(c.make_transpose());
-    // Col scaling (A)
-    for (std::size_t j{0}; j < A.n_cols(); j++)
+    Timer timer{debug_logger(), "Scaling"};
+
+    constexpr int max_geometric_passes{20};
+    constexpr Number min_improvement{0.9};
+
+    std::vector<Number> row_scale_factors(A.n_rows(), 1.0);
+    std::vector<Number> col_scale_factors(A.n_cols(), 1.0);
+
+    auto spread = scaled_spread(A, row_scale_factors, col_scale_factors);
+
+    for (int pass{0}; pass < max_geometric_passes; pass++)
     {
-        Number col_abs_max{0};
+        auto row_trial = row_scale_factors;
+        auto col_trial = col_scale_factors;
+
+        update_scale_factors(A, row_trial, col_trial, true, true);
+        update_scale_factors(A, col_trial, row_trial, false, true);
+
+        const auto trial_spread = scaled_spread(A, row_trial, col_trial);
 
-        for (std::size_t i{0}; i < A.n_rows(); i++)
+        if (trial_spread > min_improvement * spread)
         {
-            col_abs_max = std::max(col_abs_max, std::abs(A(i, j)));
+            break;
         }
 
-        col_scale_factors.push_back(1.0 / col_abs_max);
+        row_scale_factors = std::move(row_trial);
+        col_scale_factors = std::move(col_trial);
+        spread = trial_spread;
+    }
 
-        for (std::size_t i{0}; i < A.n_rows(); i++)
-        {
-            if (i == 0)
-            {
-                // Scale c here
-                c(i, j) = c(i, j) * col_scale_factors[j];
-            }
+    update_scale_factors(A, row_scale_factors, col_scale_factors, true, false);
+    round_to_power_of_two(row_scale_factors);
 
-            // A cols
-            A(i, j) = A(i, j) * col_scale_factors[j];
-        }
+    update_scale_factors(A, col_scale_factors, row_scale_factors, false, false);
+    round_to_power_of_two(col_scale_factors);
+
+    log()->debug("Spread of A: {:.3g} unscaled, {:.3g} scaled",
+                 scaled_spread(A, std::vector<Number>(A.n_rows(), 1.0), std::vector<Number>(A.n_cols(), 1.0)),
+                 scaled_spread(A, row_scale_factors, col_scale_factors));
+
+    for (std::size_t i{0}; i < A.n_rows(); i++)
+    {
+        b(i, 0) = b(i, 0) * row_scale_factors[i];
     }
 
+    for (std::size_t j{0}; j < A.n_cols(); j++)
+    {
+        c(j, 0) = c(j, 0) * col_scale_factors[j];
+    }
+
+    A.scale_rows(row_scale_factors);
+    A.scale_cols(col_scale_factors);
+
     return {row_scale_factors, col_scale_factors};
 }
 } // namespace
@@ -195,29 +740,34 @@ SolveData init_data(const Model& model)
     auto n = num_vars;
     auto m = num_constr;
 
-    // Populate A matrix
+    // Populate A matrix in one pass over the constraint entries
 
-    Mat A{m, n, 0.0};
-    for (const auto& [n_cons, cons_pair] : enumerate(model.get_constraints()))
+    std::unordered_map<const Variable*, std::size_t> var_indices;
+    var_indices.reserve(n);
+    for (const auto& [n_var, variable] : enumerate(model.get_variables()))
     {
-        assert(cons_pair.second->type() == Constraint::Type::EQUAL);
-        for (const auto& [n_var, var_pair] : enumerate(model.get_variables()))
+        var_indices[variable.get()] = n_var;
+    }
+
+    std::vector<SparseMat::Entry> entries;
+    for (const auto& [n_cons, constraint] : enumerate(model.get_constraints()))
+    {
+        assert(constraint->type() == Constraint::Type::EQUAL);
+        for (const auto& [variable, coefficient] : constraint->entries())
         {
-            auto found_entry = cons_pair.second->entries().find(var_pair.second.get());
-            if (found_entry != std::end(cons_pair.second->entries()))
-            {
-                A(n_cons, n_var) = found_entry->second;
-            }
+            entries.push_back({n_cons, var_indices.at(variable), coefficient});
         }
     }
 
+    SparseMat A{m, n, entries};
+
     log()->trace(A);
 
     // Create c column vector = [c]
     Mat c{n, 1, 0.0};
-    for (const auto& [n_var, pair] : enumerate(model.get_variables()))
+    for (const auto& [n_var, variable] : enumerate(model.get_variables()))
     {
-        c(n_var, 0) = pair.second->cost();
+        c(n_var, 0) = variable->cost();
     }
 
     if (model.sense() == Model::Sense::MIN)
@@ -229,10 +779,10 @@ SolveData init_data(const Model& model)
 
     // Create b (RHS) vector
     Mat b{m, 1, 0.0};
-    for (const auto& [n_cons, pair] : enumerate(model.get_constraints()))
+    for (const auto& [n_cons, constraint] : enumerate(model.get_constraints()))
     {
-        assert(pair.second->type() == Constraint::Type::EQUAL);
-        b(n_cons, 0) = pair.second->rhs();
+        assert(constraint->type() == Constraint::Type::EQUAL);
+        b(n_cons, 0) = constraint->rhs();
     }
 
     log()->trace(b);
@@ -240,164 +790,373 @@ SolveData init_data(const Model& model)
     // Scale
     auto [row_scale_factors, col_scale_factors] = scale_system(A, b, c);
 
+    // Bounds, in the scaled variables x' = x / col_scale
+    std::vector<Number> lower(n);
+    std::vector<Number> upper(n);
+    for (const auto& [n_var, variable] : enumerate(model.get_variables()))
+    {
+        lower[n_var] = variable->lower_bound() / col_scale_factors[n_var];
+        upper[n_var] = variable->upper_bound() / col_scale_factors[n_var];
+    }
+
     // Find the initial basis
-    std::size_t basis_size = std::ranges::count_if(model.get_variables(), [](const auto& pair) {
-        return pair.second->slack() || pair.second->artifical();
+    std::size_t basis_size = std::ranges::count_if(model.get_variables(), [](const auto& variable) {
+        return variable->slack() || variable->artifical();
     });
 
-    std::vector<VarData> basics;
-    basics.reserve(basis_size);
-    std::vector<VarData> non_basics;
-    non_basics.reserve(n - basis_size);
+    std::vector<VarData> basics;
+    basics.reserve(basis_size);
+    std::vector<VarData> non_basics;
+    non_basics.reserve(n - basis_size);
+
+    std::vector<Position> positions(n);
+
+    Mat x_basic{b};
+    Mat x_non_basic{n - basis_size, 1};
+    Mat z_non_basic{n - basis_size, 1};
+
+    for (const auto& [n_var, variable] : enumerate(model.get_variables()))
+    {
+        auto index = static_cast<int>(n_var);
+        if (variable->artifical())
+        {
+            positions[n_var] = {true, basics.size()};
+            basics.push_back({index, index, true, true});
+        }
+        else if (variable->slack())
+        {
+            positions[n_var] = {true, basics.size()};
+            basics.push_back({index, index, true, false});
+        }
+        else
+        {
+            auto slot = non_basics.size();
+            positions[n_var] = {false, slot};
+            non_basics.push_back({index, index, false, false});
+            z_non_basic(slot, 0) = -1.0 * c(n_var, 0);
+
+            // Start at a finite bound, preferring the one that is dual feasible for boxed variables
+            if (lower[n_var] > -infinity && (upper[n_var] == infinity || z_non_basic(slot, 0) >= 0.0))
+            {
+                x_non_basic(slot, 0) = lower[n_var];
+            }
+            else if (upper[n_var] < infinity)
+            {
+                x_non_basic(slot, 0) = upper[n_var];
+            }
+        }
+    }
+
+    // Dual steepest edge weights are exact for the starting slack basis (B = I after scaling)
+    std::vector<Number> dual_weights(m, 1.0);
+
+    // Devex weights start with the non-basics as the reference framework
+    std::vector<Number> devex_weights(n - basis_size, 1.0);
+
+    // For the simplex we need:
+
+    log()->trace(x_non_basic);
+    log()->trace(z_non_basic);
+
+    return {A,
+            b,
+            c,
+            x_basic,
+            x_non_basic,
+            z_non_basic,
+            basics,
+            non_basics,
+            positions,
+            lower,
+            upper,
+            dual_weights,
+            devex_weights,
+            0,
+            row_scale_factors,
+            col_scale_factors};
+}
+
+SparseLU<Number> factor_basis(const SolveData& data)
+{
+    // Sparse LU factorisation of the basis matrix, formed from the basic columns of A.
+
+    std::vector<std::size_t> columns;
+    columns.reserve(data.basics.size());
+    for (const auto& var : data.basics)
+    {
+        columns.push_back(static_cast<std::size_t>(var.index));
+    }
+
+    SparseLU<Number> lu{data.A, columns};
+
+    const auto& stats = lu.stats();
+    log()->debug(
+        "LU factor: B {} nz, L {} nz, U {} nz, fill-in {}, {} singletons", stats.basis_nonzeros, stats.l_nonzeros,
+        stats.u_nonzeros, stats.fill_in(), stats.n_singletons
+    );
+
+    return lu;
+}
+
+Mat price(const SolveData& data, const SparseVec& y)
+{
+    // Computes trans(N) * y without forming N, one entry per non-basic slot.
+    // The product is taken row-wise over the CSR copy of A, visiting only the rows of the non-zeros of y, and the
+    // entries of basic columns are skipped.
+
+    Mat result{data.non_basics.size(), 1, 0.0};
+
+    for (const auto row : y.indices())
+    {
+        const auto y_row = y[row];
+        auto cols = data.A.row_indices(row);
+        auto values = data.A.row_values(row);
+
+        for (std::size_t pos{0}; pos < cols.size(); pos++)
+        {
+            const auto& position = data.positions[cols[pos]];
+            if (!position.basic)
+            {
+                result(position.slot, 0) += values[pos] * y_row;
+            }
+        }
+    }
+
+    return result;
+}
+
+Mat price(const SolveData& data, const Mat& y)
+{
+    // Computes trans(N) * y for a dense y, one dot product with each non-basic column of A.
+
+    Mat result{data.non_basics.size(), 1, 0.0};
+
+    for (std::size_t slot{0}; const auto& var : data.non_basics)
+    {
+        const auto col = static_cast<std::size_t>(var.index);
+        auto rows = data.A.col_indices(col);
+        auto values = data.A.col_values(col);
+
+        Number sum{0.0};
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
+        {
+            sum += values[pos] * y(rows[pos], 0);
+        }
+        result(slot, 0) = sum;
+        slot++;
+    }
+
+    return result;
+}
+
+void non_basic_column(const SolveData& data, std::size_t slot, SparseVec& column)
+{
+    // Column of N for the given non-basic slot, read directly from A into column.
+
+    const auto col = static_cast<std::size_t>(data.non_basics[slot].index);
+    auto rows = data.A.col_indices(col);
+    auto values = data.A.col_values(col);
+
+    column.clear();
+    for (std::size_t pos{0}; pos < rows.size(); pos++)
+    {
+        column.set(rows[pos], values[pos]);
+    }
+}
+
+void swap_basis(SolveData& data, std::size_t row, std::size_t slot)
+{
+    // Exchange the variable in basis row with the variable in the non-basic slot.
+
+    std::swap(data.basics[row], data.non_basics[slot]);
+    data.positions[data.basics[row].index] = {true, row};
+    data.positions[data.non_basics[slot].index] = {false, slot};
+}
+
+void ftran(const SparseLU<Number>& lu, const SparseVec& b, SparseVec& dx, SparseVec& spike)
+{
+    // FTRAN into dx using the LU factorisation of the basis, kept current with Forrest-Tomlin updates.
+    // The partially transformed b is saved in spike, it is needed to update the factors if b enters the basis.
+    // b is a column of A, so is usually very sparse and the hypersparse solve applies.
+    lu.solve(b, dx, &spike);
+}
+
+void btran(const SparseLU<Number>& lu, std::size_t i, SparseVec& unit, SparseVec& rho)
+{
+    // BTRAN of the unit vector e_i into rho, using the LU factorisation of the basis.
+    unit.clear();
+    unit.set(i, 1.0);
+    lu.transpose_solve(unit, rho);
+}
+
+bool pivots_agree(Number dx_pivot, Number dz_pivot, Parameters params)
+{
+    // The pivot element from the FTRAN column (dx) and from the BTRAN row (dz) should be equal and opposite.
+    // If they differ the updated factors have lost accuracy, and the iteration should be repeated after
+    // refactoring (Koberstein, 2005).
+    return std::abs(dx_pivot + dz_pivot) <= params.EPS3 * std::abs(dz_pivot);
+}
 
-    Mat B{m, basis_size};
-    Mat N{m, n - basis_size};
+bool refactor_due(const SparseLU<Number>& lu, bool unstable, Parameters params)
+{
+    // Refactor after a fixed number of updates, or straight away if the last update lost accuracy.
+    if (unstable)
+    {
+        log()->debug("Unstable LU update");
+        return true;
+    }
+    return lu.stats().n_updates >= static_cast<std::size_t>(params.refactor_iter);
+}
 
-    Mat x_basic{b};
-    Mat z_non_basic{n - basis_size, 1};
+void recompute_x_basic(SolveData& data, const SparseLU<Number>& lu, Parameters params)
+{
+    // Recompute x_basic = inv(B) * (b - N * x_non_basic) from a fresh factorisation, removing drift from the
+    // step updates. Values within tolerance of a bound are moved onto it, so degenerate basics stay exact.
 
-    // TODO - Clean this up with std::mdspan
-    for (const auto& [n_var, var_pair] : enumerate(model.get_variables()))
+    auto rhs = data.b;
+    for (std::size_t slot{0}; slot < data.non_basics.size(); slot++)
     {
-        auto index = static_cast<int>(n_var);
-        if (var_pair.second->artifical())
+        const auto x = data.x_non_basic(slot, 0);
+        if (x != 0.0)
         {
-            basics.push_back({index, index, true, true});
-            B.update({}, {basics.size() - 1}, A.slice({}, {n_var}));
+            const auto col = static_cast<std::size_t>(data.non_basics[slot].index);
+            auto rows = data.A.col_indices(col);
+            auto values = data.A.col_values(col);
+            for (std::size_t pos{0}; pos < rows.size(); pos++)
+            {
+                rhs(rows[pos], 0) -= values[pos] * x;
+            }
         }
-        else if (var_pair.second->slack())
+    }
+
+    data.x_basic = lu.solve(rhs);
+
+    for (std::size_t row{0}; row < data.basics.size(); row++)
+    {
+        auto& x = data.x_basic(row, 0);
+        if (std::abs(x - lower_of(data, data.basics[row])) < params.EPS1)
         {
-            basics.push_back({index, index, true, false});
-            B.update({}, {basics.size() - 1}, A.slice({}, {n_var}));
+            x = lower_of(data, data.basics[row]);
         }
-        else
+        else if (std::abs(x - upper_of(data, data.basics[row])) < params.EPS1)
         {
-            non_basics.push_back({index, index, false, false});
-            N.update({}, {non_basics.size() - 1}, A.slice({}, {n_var}));
-            z_non_basic(non_basics.size() - 1, 0) = -1.0 * c(n_var, 0);
+            x = upper_of(data, data.basics[row]);
         }
     }
-
-    // For the simplex we need:
-
-    log()->trace(B);
-    log()->trace(N);
-
-    log()->trace(x_basic);
-    log()->trace(z_non_basic);
-
-    return {A, c, B, N, x_basic, z_non_basic, basics, non_basics, 0, row_scale_factors, col_scale_factors};
 }
 
-Mat eta_inverse_solve(const Mat& u, const Mat& dx, std::size_t i)
+void update_dual_weights(
+    SolveData& data, const SparseLU<Number>& lu, const SparseVec& rho, const SparseVec& dx, std::size_t row,
+    SparseVec& tau
+)
 {
-    // Solves Eta * y = u for y using the the formula from 'Linear Programming' (Vanderbei, 2020) p135.
-    // TODO: Avoid creation of e
+    // Update the dual steepest edge weights for a pivot on the given basis row, before the basis changes.
+    // rho is row of inv(B) leaving, dx the entering column, and tau = inv(B) * rho needs one more FTRAN into tau.
+    // (Forrest & Goldfarb, 1992), also "Computational Techniques of the Simplex Method" (Maros, 2003) p252.
+    // Weights that overflow are restarted at 1, as for the slack basis.
 
-    auto e = Mat(dx.n_rows(), 1);
-    e(i, 0) = 1;
-    auto y = u - (u(i, 0) / dx(i, 0)) * (dx - e);
-    return y;
-};
+    constexpr Number min_weight{1e-4};
 
-Mat eta_inverse_transpose_solve(const Mat& u, const Mat& dx, std::size_t i)
-{
-    // Solves trans(Eta) * y = u for y using the formula from 'Linear Programming' (Vanderbei, 2020) p136.
-    // TODO: Avoid creation of e
+    lu.solve(rho, tau);
+    const auto alpha_r = dx[row];
+    const auto weight_r = data.dual_weights[row];
 
-    auto e = Mat(dx.n_rows(), 1);
-    e(i, 0) = 1;
-    auto y = u - e * ((dx - e).make_transpose() * u) / dx(i, 0);
-    return y;
-};
+    for (const auto i : dx.indices())
+    {
+        if (i != row)
+        {
+            const auto ratio = dx[i] / alpha_r;
+            auto& weight = data.dual_weights[i];
+            weight = std::max(weight - 2.0 * ratio * tau[i] + ratio * ratio * weight_r, min_weight);
 
-Mat ftran(const lu_result<Number>& lu, const Mat& b, const std::vector<std::pair<Mat, std::size_t>>& etas)
-{
-    // Implement FTRAN using the eta matrix factorisation of the basis, plus the initial LU factorisation.
-    // This is comination of the implementations from:
-    // 'Linear Programming' (Vanderbei, 2020) p133.
-    // 'Linear Programming' (Chvatal, 1983) p109.
+            if (!std::isfinite(weight))
+            {
+                weight = 1.0;
+            }
+        }
+    }
 
-    // Use the LU factorisation in the first iteration.
-    auto dx = lu_solve(lu.L, lu.U, lu.perm, b);
+    data.dual_weights[row] = std::max(weight_r / (alpha_r * alpha_r), min_weight);
 
-    // Apply etas recursively to update dx.
-    for (const auto& [eta, leaving] : etas)
+    if (!std::isfinite(data.dual_weights[row]))
     {
-        dx = eta_inverse_solve(dx, eta, leaving);
+        data.dual_weights[row] = 1.0;
     }
-
-    return dx;
 }
 
-Mat btran(const lu_result<Number>& lu, const Mat& b, const std::vector<std::pair<Mat, std::size_t>>& etas)
+void update_devex_weights(SolveData& data, const Mat& dz, std::size_t slot)
 {
-    // Implement BTRAN using the eta matrix factorisation of the basis, plus the initial LU factorisation.
-    // This is comination of the implementations from:
-    // 'Linear Programming' (Vanderbei, 2020) p133.
-    // 'Linear Programming' (Chvatal, 1983) p109.
+    // Update the Devex reference weights for the variable entering from the given non-basic slot.
+    // dz is the pivot row, so dz_j / dz_q = alpha_j / alpha_q for the row of inv(B) * N.
+    // (Forrest & Goldfarb, 1992), also "Computational Techniques of the Simplex Method" (Maros, 2003) p196.
 
-    auto u = b;
+    const auto alpha_q = dz(slot, 0);
+    const auto weight_q = data.devex_weights[slot];
 
-    // Apply etas recursively in reverse to update u.
-    auto it = std::rbegin(etas);
-    while (it != std::rend(etas))
+    for (std::size_t j{0}; j < data.non_basics.size(); j++)
     {
-        u = eta_inverse_transpose_solve(u, it->first, it->second);
-        ++it;
+        if (j != slot && dz(j, 0) != 0.0)
+        {
+            const auto ratio = dz(j, 0) / alpha_q;
+            data.devex_weights[j] = std::max(data.devex_weights[j], ratio * ratio * weight_q);
+        }
     }
 
-    // Use the LU factorisation
-    auto v = lu_transpose_solve(lu.L, lu.U, lu.perm, u);
-
-    return v;
+    // The leaving variable takes the entering slot
+    data.devex_weights[slot] = std::max(weight_q / (alpha_q * alpha_q), 1.0);
 }
 
 bool solve_primal(SolveData& data, Parameters params)
 {
-    // Solve using the primal (revised) simplex algorithm.
-    // Uses implementation from 'Linear Programming' (Vanderbei, 2020) p102.
+    // Solve using the primal (revised) simplex algorithm, for variables with general bounds.
+    // Uses implementation from 'Linear Programming' (Vanderbei, 2020) p102, with the bounded ratio test
+    // from "Computational Techniques of the Simplex Method" (Maros, 2003) ch. 9.
     // Returns true if a solution is present.
 
-    Mat& A = data.A;
-    Mat& B = data.B;
-    Mat& N = data.N;
     Mat& x_basic = data.x_basic;
+    Mat& x_non_basic = data.x_non_basic;
     Mat& z_non_basic = data.z_non_basic;
-    std::vector<VarData>& basics = data.basics;
-    std::vector<VarData>& non_basics = data.non_basics;
     int& iter = data.n_iter;
 
-    // Store dx and the leaving index each iteration
-    std::vector<std::pair<Mat, std::size_t>> etas;
+    int n_degenerate{0};
+    bool perturbed{false};
 
     // Intial LU factorisation
-    auto lu_current{jsolve::lu_factor(B)};
-    int refactor_age{0};
+    auto lu_current{factor_basis(data)};
+    bool unstable{false};
+    Workspace work{data.A.n_rows()};
 
     while (iter <= params.max_iter)
     {
         iter++;
         log_iteration(iter, data);
 
-        if (refactor_age >= params.refactor_iter)
+        if (refactor_due(lu_current, unstable, params))
         {
             // Recompute LU factorisation of basis
             log()->info("Re-factoring basis...");
-            lu_current = jsolve::lu_factor(B);
-            etas.clear();
-            refactor_age = 0;
+            lu_current = factor_basis(data);
+            unstable = false;
+
+            // Recompute x_basic to remove drift from the updates
+            recompute_x_basic(data, lu_current, params);
+
+            // Reset the Devex reference framework to the current non-basics
+            std::ranges::fill(data.devex_weights, 1.0);
         }
-        else
+
+        if (params.perturb && !perturbed && n_degenerate >= params.stall_iter)
         {
-            refactor_age++;
+            log()->info("Stalling after {} degenerate iterations, perturbing bounds", n_degenerate);
+            perturb_bounds(data, params);
+            perturbed = true;
         }
 
         // 1. Check optimality
         // 2. Find entering variable
-        // Pick minimum (and negative) z_non_basic
+        // Pick the largest (weighted) dual infeasibility, it moves up if z < 0 and down if z > 0
 
-        std::optional<std::size_t> entering = choose_entering(z_non_basic, params.EPS2);
+        std::optional<std::size_t> entering = choose_entering_primal(data, params.EPS2);
 
         if (!entering)
         {
@@ -405,53 +1164,81 @@ bool solve_primal(SolveData& data, Parameters params)
             return true;
         }
 
+        const auto& entering_var = data.non_basics[entering.value()];
+        const Number direction = z_non_basic(entering.value(), 0) < 0.0 ? 1.0 : -1.0;
+        const Number range = upper_of(data, entering_var) - lower_of(data, entering_var);
+
         // 3. Calculate dx (FTRAN)
-        auto dx = ftran(lu_current, N.slice({}, entering.value()), etas);
+        non_basic_column(data, entering.value(), work.column);
+        ftran(lu_current, work.column, work.dx, work.spike);
+        const auto& dx = work.dx;
 
         // 4. Find the leaving variable
-        std::optional<std::size_t> leaving = choose_leaving(x_basic, dx, params.EPS1);
+        auto step = choose_leaving_primal(data, dx, direction, range, params);
 
-        if (!leaving)
+        if (!step)
         {
             // Unbounded
             log()->warn("Unbounded");
             return false;
         }
 
-        log()->debug("Entering: {} Leaving: {}", entering.value(), leaving.value());
-
         // 5. Calculate primal step length
-        // t = x/dx
+        auto t = direction * step->theta;
+        n_degenerate = step->theta <= params.EPS1 ? n_degenerate + 1 : 0;
+
+        if (!step->leaving)
+        {
+            // The entering variable reaches its opposite bound first, flip it without changing the basis
+            log()->debug("Bound flip: {}", entering.value());
+            update_x_basic(x_basic, dx, t);
+            x_non_basic(entering.value(), 0) = direction > 0.0 ? upper_of(data, entering_var)
+                                                               : lower_of(data, entering_var);
+            continue;
+        }
 
-        auto t = x_basic(leaving.value(), 0) / dx(leaving.value(), 0);
+        const auto leaving = step->leaving;
+
+        log()->debug("Entering: {} Leaving: {}", entering.value(), leaving.value());
 
         // 6. Calculate dz (BTRAN)
-        auto ei = Mat{B.n_rows(), 1};
-        ei(leaving.value(), 0) = 1;
+        btran(lu_current, leaving.value(), work.unit, work.rho);
+        auto dz = -1.0 * price(data, work.rho);
 
-        auto dz = -1.0 * N.make_transpose() * btran(lu_current, ei, etas);
+        if (!pivots_agree(dx[leaving.value()], dz(entering.value(), 0), params) && lu_current.stats().n_updates > 0)
+        {
+            unstable = true;
+            continue;
+        }
 
         // 7. Calculate dual step lengths
         // s = z/dz (j)
         auto s = z_non_basic(entering.value(), 0) / dz(entering.value(), 0);
 
         // 8. Update primal and dual solutions
-        x_basic = x_basic - t * dx;
-        x_basic(leaving.value(), 0) = t;
+        auto entering_value = x_non_basic(entering.value(), 0) + t;
+
+        update_x_basic(x_basic, dx, t);
+        shift_bound(data, leaving.value());
+
+        const auto& leaving_var = data.basics[leaving.value()];
+        auto leaving_value = step->to_upper ? upper_of(data, leaving_var) : lower_of(data, leaving_var);
 
         z_non_basic = z_non_basic - s * dz;
         z_non_basic(entering.value(), 0) = s;
 
-        // 9. Update variables
-        B.update({}, {leaving.value()}, A.slice({}, static_cast<std::size_t>(non_basics[entering.value()].index)));
-        N.update({}, {entering.value()}, A.slice({}, static_cast<std::size_t>(basics[leaving.value()].index)));
-        std::swap(basics[leaving.value()], non_basics[entering.value()]);
+        if (params.primal_pricing == Options::Pricing::DEVEX)
+        {
+            update_devex_weights(data, dz, entering.value());
+        }
 
-        // Save eta data
-        etas.push_back({dx, leaving.value()});
+        // 9. Update variables
+        swap_basis(data, leaving.value(), entering.value());
+        x_basic(leaving.value(), 0) = entering_value;
+        x_non_basic(entering.value(), 0) = leaving_value;
 
-        log()->trace(B);
-        log()->trace(N);
+        // Update the LU factors for the new basis
+        unstable = !lu_current.update(leaving.value(), work.spike, dx[leaving.value()]);
     }
 
     if (iter >= params.max_iter)
@@ -466,49 +1253,52 @@ bool solve_primal(SolveData& data, Parameters params)
 
 bool solve_dual(SolveData& data, Parameters params)
 {
-    // Solve using the dual (revised) simplex algorithm.
-    // Uses implementation from 'Linear Programming' (Vanderbei, 2020) p102.
+    // Solve using the dual (revised) simplex algorithm, for variables with general bounds.
+    // Uses implementation from 'Linear Programming' (Vanderbei, 2020) p102, with the bounded ratio test
+    // from "Computational Techniques of the Simplex Method" (Maros, 2003) ch. 10.
     // Returns true if a solution is present.
 
-    Mat& A = data.A;
-    Mat& B = data.B;
-    Mat& N = data.N;
     Mat& x_basic = data.x_basic;
+    Mat& x_non_basic = data.x_non_basic;
     Mat& z_non_basic = data.z_non_basic;
-    std::vector<VarData>& basics = data.basics;
-    std::vector<VarData>& non_basics = data.non_basics;
     int& iter = data.n_iter;
 
-    // Store dx and the leaving index each iteration
-    std::vector<std::pair<Mat, std::size_t>> etas;
+    int n_degenerate{0};
+    bool perturbed{false};
 
     // Intial LU factorisation
-    auto lu_current{jsolve::lu_factor(B)};
-    int refactor_age{0};
+    auto lu_current{factor_basis(data)};
+    bool unstable{false};
+    Workspace work{data.A.n_rows()};
 
     while (iter <= params.max_iter)
     {
         iter++;
         log_iteration(iter, data);
 
-        if (refactor_age >= params.refactor_iter)
+        if (refactor_due(lu_current, unstable, params))
         {
             // Recompute LU factorisation of basis
             log()->info("Re-factoring basis...");
-            lu_current = jsolve::lu_factor(B);
-            etas.clear();
-            refactor_age = 0;
+            lu_current = factor_basis(data);
+            unstable = false;
+
+            // Recompute x_basic to remove drift from the updates
+            recompute_x_basic(data, lu_current, params);
         }
-        else
+
+        if (params.perturb && !perturbed && n_degenerate >= params.stall_iter)
         {
-            refactor_age++;
+            log()->info("Stalling after {} degenerate iterations, perturbing costs", n_degenerate);
+            perturb_costs(data, params);
+            perturbed = true;
         }
 
         // 1. Check optimality
         // 2. Find entering variable
-        // Pick minimum (and negative) x_basic
+        // Pick the largest weighted primal infeasibility, it leaves the basis at the violated bound
 
-        std::optional<std::size_t> entering = choose_entering(x_basic, params.EPS2);
+        std::optional<std::size_t> entering = choose_entering_dual(data, params.EPS2);
 
         if (!entering)
         {
@@ -516,17 +1306,22 @@ bool solve_dual(SolveData& data, Parameters params)
             return true;
         }
 
-        // 3. Calculate dz (BTRAN)
-        auto ei = Mat{B.n_rows(), 1};
-        ei(entering.value(), 0) = 1;
+        const auto& entering_var = data.basics[entering.value()];
+        const bool to_lower = primal_infeasibility(data, entering.value()) < 0.0;
+        const Number sign = to_lower ? 1.0 : -1.0;
+        const Number target = to_lower ? lower_of(data, entering_var) : upper_of(data, entering_var);
 
-        auto dz = -1.0 * N.make_transpose() * btran(lu_current, ei, etas);
+        // 3. Calculate dz (BTRAN)
+        btran(lu_current, entering.value(), work.unit, work.rho);
+        const auto& rho = work.rho;
+        auto dz = -1.0 * price(data, rho);
 
         log()->trace(dz);
 
-        // 4. Find the leaving variable
+        // 4. Find the leaving variable, and the boxed variables to flip on the way
 
-        std::optional<std::size_t> leaving = choose_leaving(z_non_basic, dz, params.EPS1);
+        auto step = choose_leaving_dual(data, dz, sign, std::abs(primal_infeasibility(data, entering.value())), params);
+        const auto leaving = step.leaving;
 
         if (!leaving)
         {
@@ -537,37 +1332,54 @@ bool solve_dual(SolveData& data, Parameters params)
 
         // 5. Calculate dual step length
         // s = z/dz
+        // The Harris pass may choose a z that is slightly infeasible, shift its cost so the step is zero
 
+        shift_cost(data, leaving.value());
         auto s = z_non_basic(leaving.value(), 0) / dz(leaving.value(), 0);
+        n_degenerate = std::abs(s) <= params.EPS1 ? n_degenerate + 1 : 0;
 
         // 6. Calculate dx (FTRAN)
-        auto dx = ftran(lu_current, N.slice({}, {leaving.value()}), etas);
+        non_basic_column(data, leaving.value(), work.column);
+        ftran(lu_current, work.column, work.dx, work.spike);
+        const auto& dx = work.dx;
 
         log()->trace(dx);
 
-        // 7. Calculate dual step lengths
-        // t = x/dx (i)
+        if (!pivots_agree(dx[entering.value()], dz(leaving.value(), 0), params) && lu_current.stats().n_updates > 0)
+        {
+            unstable = true;
+            continue;
+        }
 
-        auto t = x_basic(entering.value(), 0) / dx(entering.value(), 0);
+        // 7. Flip the passed boxed variables, then calculate primal step length
+        // t = (x - bound)/dx (i)
 
-        // 8. Update primal and dual solutions
+        if (!step.flips.empty())
+        {
+            log()->debug("Bound flips: {}", step.flips.size());
+            flip_bounds(data, lu_current, step.flips, work);
+        }
 
-        x_basic = x_basic - t * dx;
-        x_basic(entering.value(), 0) = t;
+        auto t = (x_basic(entering.value(), 0) - target) / dx[entering.value()];
+
+        // 8. Update primal and dual solutions, and the steepest edge weights
+
+        auto leaving_value = x_non_basic(leaving.value(), 0) + t;
+
+        update_x_basic(x_basic, dx, t);
 
         z_non_basic = z_non_basic - s * dz;
         z_non_basic(leaving.value(), 0) = s;
 
-        // 9. Update variables
-        B.update({}, {entering.value()}, A.slice({}, static_cast<std::size_t>(non_basics[leaving.value()].index)));
-        N.update({}, {leaving.value()}, A.slice({}, static_cast<std::size_t>(basics[entering.value()].index)));
-        std::swap(basics[entering.value()], non_basics[leaving.value()]);
+        update_dual_weights(data, lu_current, rho, dx, entering.value(), work.tau);
 
-        // Save eta data
-        etas.push_back({dx, entering.value()});
+        // 9. Update variables
+        swap_basis(data, entering.value(), leaving.value());
+        x_basic(entering.value(), 0) = leaving_value;
+        x_non_basic(leaving.value(), 0) = target;
 
-        log()->trace(B);
-        log()->trace(N);
+        // Update the LU factors for the new basis
+        unstable = !lu_current.update(entering.value(), work.spike, dx[entering.value()]);
     }
 
     if (iter >= params.max_iter)
@@ -585,6 +1397,7 @@ Solution extract_solution(const Model& model, SolveData& data)
     // Extract solution from the solve data and put it into the original model.
 
     Solution sol{};
+    sol.n_iterations = data.n_iter;
 
     auto primal = calc_primal_obj(data);
 
@@ -598,16 +1411,40 @@ Solution extract_solution(const Model& model, SolveData& data)
         sol.objective = primal + model.constant();
     }
 
-    for (std::size_t idx{0}; const auto& var_data : data.basics)
+    // The solver maximises, with z = A^T y - c for the scaled and (for MIN) negated c, so the reduced cost c - A^T y
+    // is z for MIN and -z for MAX. A slack has no cost and one entry, so its z gives the dual of its row.
+    const double sign = model.sense() == Model::Sense::MIN ? 1.0 : -1.0;
+
+    const auto n_vars = model.get_variables().size();
+    const auto n_cons = model.get_constraints().size();
+
+    sol.variables.reserve(n_vars);
+    sol.primal.reserve(n_vars);
+    sol.reduced_costs.reserve(n_vars);
+    sol.constraints.reserve(n_cons);
+    sol.duals.assign(n_cons, 0.0);
+
+    for (const auto& [n_var, variable] : enumerate(model.get_variables()))
     {
-        sol.variables[model.get_variable(var_data.index)->name()] =
-            data.x_basic(idx, 0) * data.col_scale_factors[var_data.index];
-        ++idx;
+        const auto& position = data.positions[n_var];
+        const auto x = position.basic ? data.x_basic(position.slot, 0) : data.x_non_basic(position.slot, 0);
+        const auto z = position.basic ? 0.0 : data.z_non_basic(position.slot, 0) / data.col_scale_factors[n_var];
+
+        sol.variables.push_back(variable.get());
+        sol.primal.push_back(x * data.col_scale_factors[n_var]);
+        sol.reduced_costs.push_back(sign * z);
+
+        if (variable->slack())
+        {
+            const auto row = data.A.col_indices(n_var).front();
+            const auto scaled_entry = data.A.col_values(n_var).front() / data.col_scale_factors[n_var];
+            sol.duals[row] = -sign * z / scaled_entry * data.row_scale_factors[row];
+        }
     }
 
-    for (const auto& var_data : data.non_basics)
+    for (const auto& constraint : model.get_constraints())
     {
-        sol.variables[model.get_variable(var_data.index)->name()] = 0;
+        sol.constraints.push_back(constraint.get());
     }
 
     return sol;
@@ -615,12 +1452,26 @@ Solution extract_solution(const Model& model, SolveData& data)
 
 bool is_primal_feas(const SolveData& data)
 {
-    return data.x_basic.min() >= 0.0;
+    for (std::size_t row = 0; row < data.basics.size(); row++)
+    {
+        if (primal_infeasibility(data, row) != 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool is_dual_feas(const SolveData& data)
 {
-    return data.z_non_basic.min() >= 0.0;
+    for (std::size_t slot = 0; slot < data.non_basics.size(); slot++)
+    {
+        if (dual_infeasibility(data, slot) != 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool has_artificals_in_basis(const SolveData& data)
@@ -651,19 +1502,274 @@ void update_primal_objective(SolveData& data, const Mat& objective)
         idx++;
     }
 
-    auto [L, U, perm] = jsolve::lu_factor(data.B.make_transpose());
-    auto y = jsolve::forward_subs(L, c_b, perm);
-    auto v = jsolve::backward_subs(U, y);
+    auto v = factor_basis(data).transpose_solve(c_b);
+
+    data.z_non_basic.update({}, {}, data.z_non_basic + price(data, v));
+}
+
+std::size_t crash_basis(SolveData& data)
+{
+    // Crash a starting basis, "Implementing the Simplex Method: The Initial Basis" (Bixby, 1992).
+    // Structural columns replace slacks to give a triangular basis with large pivots. Columns are tried in
+    // order of preference: free, then with one finite bound, then boxed, and within each by a penalty from
+    // the bounds and cost. Fixed columns never enter.
+    // A column may only pivot in a row where no basic structural has an entry, which keeps the basis
+    // triangular. It enters if that pivot is near the largest entry in the column, or if its entries in
+    // the rows already taken are small relative to the entries there.
+    // Returns the number of structurals moved into the basis.
+
+    const auto m = data.A.n_rows();
+
+    // Basis position of the slack in each row
+    std::vector<std::optional<std::size_t>> slack_positions(m);
+    for (std::size_t pos{0}; const auto& var : data.basics)
+    {
+        auto rows = data.A.col_indices(static_cast<std::size_t>(var.index));
+        if (var.slack && rows.size() == 1)
+        {
+            slack_positions[rows[0]] = pos;
+        }
+        pos++;
+    }
+
+    struct Candidate
+    {
+        std::size_t index;
+        int category;   // 0 free, 1 one finite bound, 2 boxed
+        Number penalty; // Lower is preferred
+    };
+
+    std::vector<Candidate> candidates;
+    Number max_cost{0.0};
+    Number max_bound{0.0};
+
+    for (const auto& var : data.non_basics)
+    {
+        const auto l = lower_of(data, var);
+        const auto u = upper_of(data, var);
+        const auto index = static_cast<std::size_t>(var.index);
+
+        if (l == u)
+        {
+            continue;
+        }
+
+        if (l == -infinity && u == infinity)
+        {
+            candidates.push_back({index, 0, 0.0});
+        }
+        else if (l == -infinity || u == infinity)
+        {
+            candidates.push_back({index, 1, l > -infinity ? l : -u});
+        }
+        else
+        {
+            candidates.push_back({index, 2, l - u});
+        }
+
+        max_cost = std::max(max_cost, std::abs(data.c(index, 0)));
+        max_bound = std::max(max_bound, std::abs(candidates.back().penalty));
+    }
+
+    // Prefer small bounds, and large costs in this maximisation
+    for (auto& candidate : candidates)
+    {
+        candidate.penalty = (max_bound > 0.0 ? candidate.penalty / max_bound : 0.0) -
+                            (max_cost > 0.0 ? data.c(candidate.index, 0) / max_cost : 0.0);
+    }
+
+    std::ranges::sort(candidates, [](const auto& lhs, const auto& rhs) {
+        return std::tie(lhs.category, lhs.penalty) < std::tie(rhs.category, rhs.penalty);
+    });
+
+    std::vector<std::size_t> row_counts(m, 0); // Entries of basic structurals in each row
+    std::vector<Number> row_max(m, 0.0);       // Largest entry of basic structurals in each row
+
+    std::size_t n_crashed{0};
+
+    for (const auto& candidate : candidates)
+    {
+        auto rows = data.A.col_indices(candidate.index);
+        auto values = data.A.col_values(candidate.index);
+
+        Number col_max{0.0};
+        Number pivot{0.0};
+        std::optional<std::size_t> pivot_row;
+        bool small_in_taken_rows{true};
+
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
+        {
+            const auto i = rows[pos];
+            const auto a = std::abs(values[pos]);
+            col_max = std::max(col_max, a);
+
+            if (row_counts[i] == 0)
+            {
+                if (slack_positions[i] && a > pivot)
+                {
+                    pivot = a;
+                    pivot_row = i;
+                }
+            }
+            else if (a > 0.01 * row_max[i])
+            {
+                small_in_taken_rows = false;
+            }
+        }
+
+        if (!pivot_row || (pivot < 0.99 * col_max && !small_in_taken_rows))
+        {
+            continue;
+        }
+
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
+        {
+            row_counts[rows[pos]]++;
+            row_max[rows[pos]] = std::max(row_max[rows[pos]], std::abs(values[pos]));
+        }
+
+        // The slack leaves at a finite bound
+        const auto slot = data.positions[candidate.index].slot;
+        swap_basis(data, slack_positions[pivot_row.value()].value(), slot);
+        slack_positions[pivot_row.value()].reset();
+
+        const auto& slack = data.non_basics[slot];
+        data.x_non_basic(slot, 0) = lower_of(data, slack) > -infinity ? lower_of(data, slack)
+                                    : upper_of(data, slack) < infinity ? upper_of(data, slack)
+                                                                       : 0.0;
+        n_crashed++;
+    }
+
+    // Duals for the new basis
+    update_primal_objective(data, data.c);
+
+    return n_crashed;
+}
+
+struct Infeasibility
+{
+    // Largest violations of the solution in the units of the model as given
+    Number primal{0.0}; // Bound violation of a variable, or b - A x of a row
+    Number dual{0.0};   // Reduced cost of the wrong sign for the bound a non-basic sits at
+};
+
+Infeasibility unscaled_infeasibility(const SolveData& data)
+{
+    // The solver's tolerances apply to the scaled model, with x' = x / col_scale, A' = R A C, b' = R b and
+    // z' = col_scale * z. Unscaling multiplies a bound violation by its column factor and divides a row residual
+    // by its row factor and a reduced cost by its column factor, which can take either past the tolerances.
+
+    Infeasibility infeasibility{};
+
+    for (std::size_t row{0}; row < data.basics.size(); row++)
+    {
+        const auto index = static_cast<std::size_t>(data.basics[row].index);
+        infeasibility.primal =
+            std::max(infeasibility.primal, std::abs(primal_infeasibility(data, row)) * data.col_scale_factors[index]);
+    }
+
+    auto residual = data.b;
+    for (std::size_t col{0}; col < data.A.n_cols(); col++)
+    {
+        const auto& position = data.positions[col];
+        const auto x = position.basic ? data.x_basic(position.slot, 0) : data.x_non_basic(position.slot, 0);
+        if (x != 0.0)
+        {
+            auto rows = data.A.col_indices(col);
+            auto values = data.A.col_values(col);
+            for (std::size_t pos{0}; pos < rows.size(); pos++)
+            {
+                residual(rows[pos], 0) -= values[pos] * x;
+            }
+        }
+    }
+    for (std::size_t row{0}; row < data.A.n_rows(); row++)
+    {
+        infeasibility.primal =
+            std::max(infeasibility.primal, std::abs(residual(row, 0)) / data.row_scale_factors[row]);
+    }
+
+    for (std::size_t slot{0}; slot < data.non_basics.size(); slot++)
+    {
+        const auto index = static_cast<std::size_t>(data.non_basics[slot].index);
+        infeasibility.dual =
+            std::max(infeasibility.dual, std::abs(dual_infeasibility(data, slot)) / data.col_scale_factors[index]);
+    }
+
+    return infeasibility;
+}
+
+bool remove_bound_shifts(
+    SolveData& data, const std::vector<Number>& lower, const std::vector<Number>& upper, Parameters params
+)
+{
+    // Restore the original bounds after bound shifting. Non-basics at a shifted bound move to the original
+    // one, and x_basic is recomputed. Returns true if any bound had been shifted.
+
+    if (data.lower == lower && data.upper == upper)
+    {
+        return false;
+    }
+
+    for (std::size_t slot{0}; const auto& var : data.non_basics)
+    {
+        auto& x = data.x_non_basic(slot, 0);
+        const auto index = static_cast<std::size_t>(var.index);
+
+        if (x == data.lower[index])
+        {
+            x = lower[index];
+        }
+        else if (x == data.upper[index])
+        {
+            x = upper[index];
+        }
+        slot++;
+    }
+
+    data.lower = lower;
+    data.upper = upper;
+
+    recompute_x_basic(data, factor_basis(data), params);
 
-    auto N_t = data.N.make_transpose();
-    data.z_non_basic.update({}, {}, data.z_non_basic + (N_t * v));
+    return true;
 }
 
-std::optional<Solution> solve_simplex_revised(const Model& model)
+std::optional<Solution> solve_simplex_revised(const Model& model, const Options& options)
 {
+    for (const auto& variable : model.get_variables())
+    {
+        if (variable->lower_bound() > variable->upper_bound())
+        {
+            log()->warn("Variable {} has lower bound above its upper bound", variable->name());
+            log()->warn("Infeasible");
+            return std::nullopt;
+        }
+    }
+
     // Setup
     SolveData data{init_data(model)};
     Parameters params{};
+    params.primal_pricing = options.primal_pricing;
+    params.perturb = options.perturbation;
+
+    // A fixed limit stops large models short of optimal (FIT2P needs 21457 iterations), so allow a few per row and
+    // column of A
+    params.max_iter = std::max(params.max_iter, 4 * static_cast<int>(data.A.n_rows() + data.A.n_cols()));
+
+    if (options.crash == Options::Crash::BIXBY)
+    {
+        const auto n_crashed = crash_basis(data);
+        log()->info("Crash basis: {} of {} rows have a structural", n_crashed, data.basics.size());
+    }
+
+    // Basic values for the starting non-basic values
+    recompute_x_basic(data, factor_basis(data), params);
+
+    // The ratio tests shift bounds and costs, keep the originals
+    const auto original_c = data.c;
+    const auto original_lower = data.lower;
+    const auto original_upper = data.upper;
 
     bool has_solution{false};
     bool primal_feas{is_primal_feas(data)};
@@ -689,15 +1795,26 @@ std::optional<Solution> solve_simplex_revised(const Model& model)
         log()->info("Starting basis is primal and dual infeasible, starting phase 1 with dummy objective");
 
         // Use 2 phase procedure:
-        // 1. Change to dummy dual feasible objective (all -1's) and solve using dual simplex
+        // 1. Change to a dummy dual feasible objective and solve using dual simplex. Non-basics at a lower
+        //    bound get a cost of -1, at an upper bound +1, and free or fixed ones 0.
         // 2. Restore original objective and solve using primal simplex.
 
-        auto original_c = data.c;
-
         auto dummy_c = Mat{original_c.n_rows(), original_c.n_cols(), 0};
-        for (const auto& var : data.non_basics)
+        for (std::size_t slot{0}; const auto& var : data.non_basics)
         {
-            dummy_c(var.index, 0) = -1.0;
+            const auto x = data.x_non_basic(slot, 0);
+            const bool at_lower = x == lower_of(data, var);
+            const bool at_upper = x == upper_of(data, var);
+
+            if (at_lower && !at_upper)
+            {
+                dummy_c(var.index, 0) = -1.0;
+            }
+            else if (at_upper && !at_lower)
+            {
+                dummy_c(var.index, 0) = 1.0;
+            }
+            slot++;
         }
 
         update_primal_objective(data, dummy_c);
@@ -718,6 +1835,90 @@ std::optional<Solution> solve_simplex_revised(const Model& model)
         }
     }
 
+    // Remove the shifts and perturbations, then clean up with a few more iterations if the original problem is
+    // not optimal. With bounds restored the basis stays dual feasible for the dual simplex, and with costs
+    // restored it stays primal feasible for the primal simplex. The cleanup is not perturbed again, but its ratio
+    // tests may shift again, so the passes are capped.
+    // Once unshifted, the tolerances met on the scaled model may still leave the unscaled one infeasible. The
+    // tolerances are then tightened for another pass of the dual (primal infeasible) or primal (dual infeasible).
+    params.perturb = false;
+
+    int n_cleanup{0};
+
+    while (has_solution)
+    {
+        const bool shifted = data.c != original_c || data.lower != original_lower || data.upper != original_upper;
+
+        Infeasibility infeasibility{};
+        if (!shifted)
+        {
+            recompute_x_basic(data, factor_basis(data), params);
+            update_primal_objective(data, data.c);
+
+            infeasibility = unscaled_infeasibility(data);
+            if (infeasibility.primal <= params.EPS7 && infeasibility.dual <= params.EPS7)
+            {
+                break;
+            }
+        }
+
+        if (n_cleanup == params.max_cleanup)
+        {
+            if (shifted)
+            {
+                log()->warn("Shifts remain after {} cleanup passes, no solution to the original problem", n_cleanup);
+                has_solution = false;
+            }
+            else
+            {
+                log()->warn("Solution is inaccurate after {} cleanup passes, unscaled infeasibility primal {:.3g}, "
+                            "dual {:.3g}",
+                            n_cleanup, infeasibility.primal, infeasibility.dual);
+            }
+            break;
+        }
+        n_cleanup++;
+
+        if (!shifted)
+        {
+            params.EPS2 /= 100;
+            params.EPS4 /= 100;
+            params.EPS5 /= 100;
+
+            log()->info("Unscaled infeasibility primal {:.3g}, dual {:.3g}, tightening tolerances",
+                        infeasibility.primal, infeasibility.dual);
+
+            if (infeasibility.primal > params.EPS7)
+            {
+                if (choose_entering_dual(data, params.EPS2))
+                {
+                    has_solution = solve_dual(data, params);
+                }
+            }
+            else if (choose_entering_primal(data, params.EPS2))
+            {
+                has_solution = solve_primal(data, params);
+            }
+        }
+        else if (remove_bound_shifts(data, original_lower, original_upper, params))
+        {
+            log()->info("Removed bound shifts");
+            if (choose_entering_dual(data, params.EPS2))
+            {
+                has_solution = solve_dual(data, params);
+            }
+        }
+        else
+        {
+            log()->info("Removed cost shifts");
+            update_primal_objective(data, original_c);
+            if (choose_entering_primal(data, params.EPS2))
+            {
+                has_solution = solve_primal(data, params);
+            }
+        }
+    }
+
     std::optional<Solution> solution;
 
     if (has_solution)
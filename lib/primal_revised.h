@@ -1,11 +1,12 @@
 #pragma once
 
 #include "model.h"
+#include "options.h"
 #include "solution.h"
 
 #include <optional>
 
 namespace jsolve
 {
-std::optional<Solution> solve_simplex_revised(const Model& model);
+std::optional<Solution> solve_simplex_revised(const Model& model, const Options& options);
 }
\ No newline at end of file
@@ -1,13 +1,133 @@
 #include "simplex.h"
+#include "presolve.h"
 #include "primal_revised.h"
 #include "simplex_common.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace jsolve
 {
-std::optional<Solution> solve(Model& model)
+namespace
+{
+template <typename T>
+std::unordered_map<const T*, std::size_t> positions_of(const std::vector<const T*>& items)
+{
+    std::unordered_map<const T*, std::size_t> positions;
+    positions.reserve(items.size());
+    for (std::size_t n_item = 0; n_item < items.size(); n_item++)
+    {
+        positions.emplace(items[n_item], n_item);
+    }
+    return positions;
+}
+
+Solution in_order_of(const Solution& reduced, std::vector<const Variable*> variables,
+                     std::vector<const Constraint*> constraints, bool with_duals)
+{
+    // Move the values solved for the reduced model to the positions of the same variables and constraints in the
+    // model as it was given. Slacks added by pre-processing are dropped, and anything presolve removed stays at 0
+    // until postsolve fills in its value. Duals and reduced costs are only moved when asked for.
+
+    Solution solution{reduced.objective};
+    solution.n_iterations = reduced.n_iterations;
+
+    solution.primal.assign(variables.size(), 0.0);
+    if (with_duals)
+    {
+        solution.reduced_costs.assign(variables.size(), 0.0);
+        solution.duals.assign(constraints.size(), 0.0);
+    }
+
+    const auto variable_positions = positions_of(variables);
+    for (std::size_t n_var = 0; n_var < reduced.variables.size(); n_var++)
+    {
+        if (auto found = variable_positions.find(reduced.variables[n_var]); found != std::end(variable_positions))
+        {
+            solution.primal[found->second] = reduced.primal[n_var];
+            if (with_duals)
+            {
+                solution.reduced_costs[found->second] = reduced.reduced_costs[n_var];
+            }
+        }
+    }
+
+    if (with_duals)
+    {
+        const auto constraint_positions = positions_of(constraints);
+        for (std::size_t n_cons = 0; n_cons < reduced.constraints.size(); n_cons++)
+        {
+            solution.duals[constraint_positions.at(reduced.constraints[n_cons])] = reduced.duals[n_cons];
+        }
+    }
+
+    solution.variables = std::move(variables);
+    solution.constraints = std::move(constraints);
+
+    return solution;
+}
+} // namespace
+
+std::optional<Solution> solve(Model& model, const Options& options)
 {
     Timer timer{info_logger(), "Solving"};
+
+    // The solution is given in the order of the model as it is now, before presolve and pre-processing change it
+    std::vector<const Variable*> variables;
+    variables.reserve(model.get_variables().size());
+    for (const auto& variable : model.get_variables())
+    {
+        variables.push_back(variable.get());
+    }
+
+    std::vector<const Constraint*> constraints;
+    constraints.reserve(model.get_constraints().size());
+    for (const auto& constraint : model.get_constraints())
+    {
+        constraints.push_back(constraint.get());
+    }
+
+    PostsolveStack postsolve_stack;
+
+    if (options.presolve)
+    {
+        if (auto status = presolve(model, postsolve_stack); status != PresolveStatus::REDUCED)
+        {
+            log()->warn(status == PresolveStatus::INFEASIBLE ? "Infeasible (presolve)" : "Unbounded (presolve)");
+            return std::nullopt;
+        }
+    }
+
     pre_process_model(model);
-    return solve_simplex_revised(model);
+
+    std::optional<Solution> reduced;
+
+    if (model.get_variables().empty())
+    {
+        // Presolve removed everything
+        reduced = Solution{model.constant()};
+        log()->info("Objective = {:.2f} (0 iterations)", reduced->objective);
+    }
+    else
+    {
+        reduced = solve_simplex_revised(model, options);
+    }
+
+    if (!reduced)
+    {
+        return std::nullopt;
+    }
+
+    // Postsolve only recovers primal values, and the duals of a changed model are not those of the model as given
+    const bool with_duals = postsolve_stack.empty();
+    if (!with_duals)
+    {
+        log()->info("Duals and reduced costs are left out as presolve changed the model");
+    }
+
+    auto solution = in_order_of(reduced.value(), std::move(variables), std::move(constraints), with_duals);
+    postsolve(postsolve_stack, solution);
+
+    return solution;
 }
 } // namespace jsolve
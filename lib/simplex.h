@@ -1,11 +1,15 @@
 #pragma once
 
 #include "model.h"
+#include "options.h"
 #include "solution.h"
 
 #include <optional>
 
 namespace jsolve
 {
-std::optional<Solution> solve(Model& model);
+// Solve the model, giving the solution in the order of its variables and constraints as they are on entry.
+// The model is changed in place and should not be solved again: presolve removes what it reduces (keeping it alive
+// for the solution's names) and pre-processing adds a slack to each constraint. Read the model again to re-solve it.
+std::optional<Solution> solve(Model& model, const Options& options = {});
 } // namespace jsolve
@@ -3,6 +3,8 @@
 #include "model.h"
 
 #include "matrix.h"
+#include "sparse_matrix.h"
+#include "sparse_vector.h"
 #include "tools.h"
 
 #include <map>
@@ -11,6 +13,8 @@ namespace jsolve
 {
 using Number = double;
 using Mat = Matrix<Number>;
+using SparseMat = SparseMatrix<Number>;
+using SparseVec = SparseVector<Number>;
 
 struct VarData
 {
@@ -0,0 +1,392 @@
+#include "snapshot.h"
+
+#include "mapped_file.h"
+#include "tools.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr std::array<char, 8> snapshot_magic{'J', 'S', 'O', 'L', 'V', 'E', 'S', 'N'};
+constexpr std::uint32_t snapshot_version{1};
+constexpr std::uint32_t byte_order_mark{0x01020304};
+
+constexpr std::uint8_t slack_flag{1};
+constexpr std::uint8_t artificial_flag{2};
+
+struct Header
+{
+    // Offsets are in bytes from the start of the file, and each array starts on an 8 byte boundary
+
+    std::array<char, 8> magic{snapshot_magic};
+    std::uint32_t version{snapshot_version};
+    std::uint32_t byte_order{byte_order_mark};
+
+    std::uint64_t n_cols{0};
+    std::uint64_t n_rows{0};
+    std::uint64_t n_entries{0};
+    std::uint64_t n_name_bytes{0};
+
+    std::uint32_t sense{0};
+    std::uint32_t unused{0};
+    double constant{0.0};
+
+    std::uint64_t costs{0};        // double[n_cols]
+    std::uint64_t lower_bounds{0}; // double[n_cols]
+    std::uint64_t upper_bounds{0}; // double[n_cols]
+    std::uint64_t col_flags{0};    // uint8[n_cols], slack and artificial flags
+    std::uint64_t col_starts{0};   // uint64[n_cols + 1], into row_indices and values
+    std::uint64_t row_indices{0};  // uint32[n_entries]
+    std::uint64_t values{0};       // double[n_entries]
+    std::uint64_t row_types{0};    // uint8[n_rows], Constraint::Type
+    std::uint64_t rhs{0};          // double[n_rows]
+    std::uint64_t ranges{0};       // double[n_rows]
+    std::uint64_t name_starts{0};  // uint64[n_cols + n_rows + 3], the model, objective, cols then rows, and the end
+    std::uint64_t names{0};        // char[n_name_bytes]
+};
+
+class SnapshotWriter
+{
+    // Appends arrays to the file, padding each to start on an 8 byte boundary
+
+  public:
+    explicit SnapshotWriter(const std::filesystem::path& path)
+        : m_file{path, std::ios::out | std::ios::binary | std::ios::trunc}
+    {
+        if (!m_file.is_open())
+        {
+            throw jsolve::SnapshotError(fmt::format("File could not be opened: {}", path));
+        }
+    }
+
+    // Returns the offset the array was written at
+    template <typename T>
+    std::uint64_t write(std::span<const T> items)
+    {
+        constexpr std::array<char, 8> padding{};
+        m_file.write(padding.data(), static_cast<std::streamsize>((8 - m_offset % 8) % 8));
+        m_offset += (8 - m_offset % 8) % 8;
+
+        const auto offset = m_offset;
+        m_file.write(reinterpret_cast<const char*>(items.data()), static_cast<std::streamsize>(items.size_bytes()));
+        m_offset += items.size_bytes();
+
+        return offset;
+    }
+
+    void write_header(const Header& header)
+    {
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!m_file)
+        {
+            throw jsolve::SnapshotError("Snapshot could not be written");
+        }
+    }
+
+  private:
+    std::ofstream m_file;
+    std::uint64_t m_offset{0};
+};
+
+template <typename T>
+std::span<const T> array_at(std::string_view bytes, std::uint64_t offset, std::uint64_t count)
+{
+    // A view of an array in the mapped file, checked to lie inside it
+
+    if (offset % alignof(T) != 0 || offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T))
+    {
+        throw jsolve::SnapshotError("Snapshot is truncated or corrupt");
+    }
+
+    return {reinterpret_cast<const T*>(bytes.data() + offset), static_cast<std::size_t>(count)};
+}
+} // namespace
+
+namespace jsolve
+{
+SnapshotError::SnapshotError(const std::string& message)
+    : std::runtime_error(message)
+{
+}
+
+SnapshotError::~SnapshotError() = default;
+
+void write_snapshot(const Model& model, const std::filesystem::path& path)
+{
+    // Constraint entries are held by row, so the compressed columns are found with a count of each column then a
+    // second pass filling them, giving row indices in increasing order within each column.
+
+    Timer timer{info_logger(), "Writing snapshot {}", path};
+
+    const auto& variables = model.get_variables();
+    const auto& constraints = model.get_constraints();
+
+    if (constraints.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw SnapshotError("Too many constraints for a snapshot");
+    }
+
+    std::unordered_map<const Variable*, std::size_t> col_indices;
+    col_indices.reserve(variables.size());
+
+    std::vector<double> costs;
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    std::vector<std::uint8_t> col_flags;
+
+    for (const auto& variable : variables)
+    {
+        col_indices.emplace(variable.get(), col_indices.size());
+        costs.push_back(variable->cost());
+        lower_bounds.push_back(variable->lower_bound());
+        upper_bounds.push_back(variable->upper_bound());
+        col_flags.push_back((variable->slack() ? slack_flag : 0) | (variable->artifical() ? artificial_flag : 0));
+    }
+
+    std::vector<std::uint64_t> col_starts(variables.size() + 1, 0);
+    std::vector<std::uint8_t> row_types;
+    std::vector<double> rhs;
+    std::vector<double> ranges;
+
+    for (const auto& constraint : constraints)
+    {
+        for (const auto& [variable, _] : constraint->entries())
+        {
+            col_starts[col_indices.at(variable) + 1]++;
+        }
+
+        row_types.push_back(static_cast<std::uint8_t>(constraint->type()));
+        rhs.push_back(constraint->rhs());
+        ranges.push_back(constraint->range());
+    }
+
+    for (std::size_t col{0}; col < variables.size(); col++)
+    {
+        col_starts[col + 1] += col_starts[col];
+    }
+
+    std::vector<std::uint32_t> row_indices(col_starts.back());
+    std::vector<double> values(col_starts.back());
+    std::vector<std::uint64_t> next{col_starts.begin(), col_starts.end() - 1};
+
+    for (std::size_t row{0}; row < constraints.size(); row++)
+    {
+        for (const auto& [variable, value] : constraints[row]->entries())
+        {
+            auto& pos = next[col_indices.at(variable)];
+            row_indices[pos] = static_cast<std::uint32_t>(row);
+            values[pos] = value;
+            pos++;
+        }
+    }
+
+    std::vector<std::uint64_t> name_starts;
+    std::string names;
+
+    auto add_name = [&](std::string_view name) {
+        name_starts.push_back(names.size());
+        names.append(name);
+    };
+
+    add_name(model.name());
+    add_name(model.objective_name());
+
+    for (const auto& variable : variables)
+    {
+        add_name(variable->name());
+    }
+
+    for (const auto& constraint : constraints)
+    {
+        add_name(constraint->name());
+    }
+
+    name_starts.push_back(names.size());
+
+    Header header;
+    header.n_cols = variables.size();
+    header.n_rows = constraints.size();
+    header.n_entries = values.size();
+    header.n_name_bytes = names.size();
+    header.sense = static_cast<std::uint32_t>(model.sense());
+    header.constant = model.constant();
+
+    SnapshotWriter writer{path};
+
+    // The header is written again once the offsets are known
+    writer.write(std::span<const Header>{&header, 1});
+
+    header.costs = writer.write(std::span<const double>{costs});
+    header.lower_bounds = writer.write(std::span<const double>{lower_bounds});
+    header.upper_bounds = writer.write(std::span<const double>{upper_bounds});
+    header.col_flags = writer.write(std::span<const std::uint8_t>{col_flags});
+    header.col_starts = writer.write(std::span<const std::uint64_t>{col_starts});
+    header.row_indices = writer.write(std::span<const std::uint32_t>{row_indices});
+    header.values = writer.write(std::span<const double>{values});
+    header.row_types = writer.write(std::span<const std::uint8_t>{row_types});
+    header.rhs = writer.write(std::span<const double>{rhs});
+    header.ranges = writer.write(std::span<const double>{ranges});
+    header.name_starts = writer.write(std::span<const std::uint64_t>{name_starts});
+    header.names = writer.write(std::span<const char>{names});
+
+    writer.write_header(header);
+}
+
+jsolve::Model read_snapshot(const std::filesystem::path& path)
+{
+    // The file is mapped and its arrays used in place. Only the names are copied, into the variables and
+    // constraints, and each column's entries are appended to the rows in order, so no row is searched.
+
+    Timer timer{info_logger(), "Reading snapshot {}", path};
+
+    if (!std::filesystem::exists(path))
+    {
+        throw SnapshotError(fmt::format("File does not exist: {}", path));
+    }
+
+    std::optional<MappedFile> file;
+
+    try
+    {
+        file.emplace(path);
+    }
+    catch (const std::system_error&)
+    {
+        throw SnapshotError(fmt::format("File could not be opened: {}", path));
+    }
+
+    const auto bytes = file->view();
+
+    Header header;
+
+    if (bytes.size() < sizeof(header))
+    {
+        throw SnapshotError(fmt::format("Not a snapshot: {}", path));
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != snapshot_magic)
+    {
+        throw SnapshotError(fmt::format("Not a snapshot: {}", path));
+    }
+    else if (header.byte_order != byte_order_mark)
+    {
+        throw SnapshotError("Snapshot was written with a different byte order");
+    }
+    else if (header.version != snapshot_version)
+    {
+        throw SnapshotError(fmt::format("Unsupported snapshot version {}", header.version));
+    }
+
+    const auto n_cols = static_cast<std::size_t>(header.n_cols);
+    const auto n_rows = static_cast<std::size_t>(header.n_rows);
+
+    const auto costs = array_at<double>(bytes, header.costs, n_cols);
+    const auto lower_bounds = array_at<double>(bytes, header.lower_bounds, n_cols);
+    const auto upper_bounds = array_at<double>(bytes, header.upper_bounds, n_cols);
+    const auto col_flags = array_at<std::uint8_t>(bytes, header.col_flags, n_cols);
+    const auto col_starts = array_at<std::uint64_t>(bytes, header.col_starts, header.n_cols + 1);
+    const auto row_indices = array_at<std::uint32_t>(bytes, header.row_indices, header.n_entries);
+    const auto values = array_at<double>(bytes, header.values, header.n_entries);
+    const auto row_types = array_at<std::uint8_t>(bytes, header.row_types, n_rows);
+    const auto rhs = array_at<double>(bytes, header.rhs, n_rows);
+    const auto ranges = array_at<double>(bytes, header.ranges, n_rows);
+    const auto name_starts = array_at<std::uint64_t>(bytes, header.name_starts, header.n_cols + header.n_rows + 3);
+    const auto names = array_at<char>(bytes, header.names, header.n_name_bytes);
+
+    auto name = [&](std::size_t index) {
+        if (name_starts[index] > name_starts[index + 1] || name_starts[index + 1] > names.size())
+        {
+            throw SnapshotError("Snapshot is truncated or corrupt");
+        }
+
+        return std::string{names.data() + name_starts[index], names.data() + name_starts[index + 1]};
+    };
+
+    if (header.sense != static_cast<std::uint32_t>(Model::Sense::MIN) &&
+        header.sense != static_cast<std::uint32_t>(Model::Sense::MAX))
+    {
+        throw SnapshotError("Snapshot is truncated or corrupt");
+    }
+
+    Model model{static_cast<Model::Sense>(header.sense), name(0)};
+    model.objective_name() = name(1);
+    model.constant() = header.constant;
+    model.reserve(n_cols, n_rows);
+
+    std::vector<Constraint*> constraints;
+    constraints.reserve(n_rows);
+
+    for (std::size_t row{0}; row < n_rows; row++)
+    {
+        if (row_types[row] > static_cast<std::uint8_t>(Constraint::Type::EQUAL))
+        {
+            throw SnapshotError("Snapshot is truncated or corrupt");
+        }
+
+        auto* constraint = model.make_constraint(static_cast<Constraint::Type>(row_types[row]), name(2 + n_cols + row));
+        constraint->rhs() = rhs[row];
+        constraint->range() = ranges[row];
+        constraints.push_back(constraint);
+    }
+
+    std::vector<std::size_t> row_counts(n_rows, 0);
+
+    for (const auto row : row_indices)
+    {
+        if (row >= n_rows)
+        {
+            throw SnapshotError("Snapshot is truncated or corrupt");
+        }
+
+        row_counts[row]++;
+    }
+
+    for (std::size_t row{0}; row < n_rows; row++)
+    {
+        constraints[row]->entries().reserve(row_counts[row]);
+    }
+
+    for (std::size_t col{0}; col < n_cols; col++)
+    {
+        auto* variable = model.make_variable(Variable::Type::LINEAR, name(2 + col));
+        variable->cost() = costs[col];
+        variable->lower_bound() = lower_bounds[col];
+        variable->upper_bound() = upper_bounds[col];
+        variable->slack() = col_flags[col] & slack_flag;
+        variable->artifical() = col_flags[col] & artificial_flag;
+
+        if (col_starts[col] > col_starts[col + 1] || col_starts[col + 1] > header.n_entries)
+        {
+            throw SnapshotError("Snapshot is truncated or corrupt");
+        }
+
+        // Variables are made in column order, so each entry goes at the end of its row
+        for (auto pos = col_starts[col]; pos < col_starts[col + 1]; pos++)
+        {
+            auto* constraint = constraints[row_indices[pos]];
+            if (!constraint->entries().try_emplace(variable, values[pos]).second)
+            {
+                throw SnapshotError(
+                    fmt::format("Snapshot has two entries for {} in {}", variable->name(), constraint->name())
+                );
+            }
+        }
+    }
+
+    return model;
+}
+} // namespace jsolve
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "model.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace jsolve
+{
+class SnapshotError : public std::runtime_error
+{
+  public:
+    explicit SnapshotError(const std::string& message);
+    virtual ~SnapshotError();
+};
+
+// A model snapshot is a binary file holding a model as arrays: a versioned header of sizes and array offsets, then
+// column costs, bounds and flags, the constraint matrix in compressed column form, row types, sides and ranges, and
+// a table of names. Snapshots are written and read on machines of the same byte order.
+// Reading maps the file and checks the arrays in place, but still builds a Model from them, copying every name and
+// making each Variable, Constraint and entry. It saves the text parsing of an MPS file, not the copies.
+
+void write_snapshot(const Model& model, const std::filesystem::path& path);
+
+jsolve::Model read_snapshot(const std::filesystem::path& path);
+
+} // namespace jsolve
@@ -0,0 +1,102 @@
+#include "solution.h"
+
+#include "tools.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+namespace jsolve
+{
+namespace
+{
+constexpr std::size_t flush_bytes{1 << 16};
+
+void flush(std::ofstream& file, fmt::memory_buffer& buffer)
+{
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+} // namespace
+
+bool Solution::has_duals() const
+{
+    return duals.size() == constraints.size() && reduced_costs.size() == variables.size();
+}
+
+double Solution::primal_of(std::string_view name) const
+{
+    for (std::size_t n_var = 0; n_var < variables.size(); n_var++)
+    {
+        if (variables[n_var]->name() == name)
+        {
+            return primal[n_var];
+        }
+    }
+
+    throw std::out_of_range(fmt::format("Variable {} is not in the solution", name));
+}
+
+void write_solution(const Solution& solution, const std::filesystem::path& path)
+{
+    // Lines are formatted into one buffer that is written out whenever it fills, so nothing is held per entry.
+    // Values are written in their shortest form that reads back exactly.
+
+    Timer timer{info_logger(), "Writing solution {}", path};
+
+    std::ofstream file{path, std::ios::out | std::ios::binary};
+
+    if (!file.is_open())
+    {
+        throw std::system_error(std::make_error_code(std::errc::io_error), path.string());
+    }
+
+    const bool with_duals = solution.has_duals();
+
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "OBJECTIVE {}\n", solution.objective);
+
+    fmt::format_to(std::back_inserter(buffer), "COLUMNS\n");
+    for (std::size_t n_var = 0; n_var < solution.variables.size(); n_var++)
+    {
+        if (with_duals)
+        {
+            fmt::format_to(std::back_inserter(buffer), "{} {} {}\n", solution.variables[n_var]->name(),
+                           solution.primal[n_var], solution.reduced_costs[n_var]);
+        }
+        else
+        {
+            fmt::format_to(std::back_inserter(buffer), "{} {}\n", solution.variables[n_var]->name(),
+                           solution.primal[n_var]);
+        }
+
+        if (buffer.size() >= flush_bytes)
+        {
+            flush(file, buffer);
+        }
+    }
+
+    if (with_duals)
+    {
+        fmt::format_to(std::back_inserter(buffer), "ROWS\n");
+    }
+    for (std::size_t n_cons = 0; with_duals && n_cons < solution.constraints.size(); n_cons++)
+    {
+        fmt::format_to(std::back_inserter(buffer), "{} {}\n", solution.constraints[n_cons]->name(),
+                       solution.duals[n_cons]);
+
+        if (buffer.size() >= flush_bytes)
+        {
+            flush(file, buffer);
+        }
+    }
+
+    flush(file, buffer);
+
+    if (!file)
+    {
+        throw std::system_error(std::make_error_code(std::errc::io_error), path.string());
+    }
+}
+} // namespace jsolve
@@ -1,26 +1,52 @@
 #pragma once
 
+#include "constraint.h"
 #include "logging.h"
 #include "variable.h"
 
-#include <map>
+#include <filesystem>
+#include <string_view>
+#include <vector>
 
 namespace jsolve
 {
 struct Solution
 {
+    // Values are held by position, in the order of the model's variables and constraints when it was given to solve.
+    // Names are only read through the model's own variables and constraints when needed, which the model keeps
+    // alive even once presolve has removed them, so a solution must not outlive its model.
+    // Reduced costs are c - A^T y for the duals y, for either sense. Postsolve only recovers primal values, so both
+    // are left empty when presolve changed the model.
+
     double objective{0.0};
-    std::map<std::string, double> variables;
+
+    std::vector<const Variable*> variables{};
+    std::vector<double> primal{};
+    std::vector<double> reduced_costs{};
+
+    std::vector<const Constraint*> constraints{};
+    std::vector<double> duals{};
+
+    int n_iterations{0}; // Simplex iterations, including those cleaning up after perturbation
+
+    bool has_duals() const;
+
+    // Primal value of the named variable, searching the variables in order
+    double primal_of(std::string_view name) const;
 };
 
+// Write the objective, then under COLUMNS a line per variable (name, value and reduced cost) and under ROWS a line per
+// constraint (name and dual). Without duals the reduced costs and the ROWS section are left out.
+void write_solution(const Solution& solution, const std::filesystem::path& path);
+
 template <typename Log>
 void log_solution(Log log, const Solution& sol)
 {
     log("Optimal solution = {}", sol.objective);
     log("Variable values:");
-    for (const auto& [name, value] : sol.variables)
+    for (std::size_t n_var = 0; n_var < sol.variables.size(); n_var++)
     {
-        log("{} = {}", name, value);
+        log("{} = {}", sol.variables[n_var]->name(), sol.primal[n_var]);
     }
 }
 } // namespace jsolve
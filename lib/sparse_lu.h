@@ -0,0 +1,975 @@
+#pragma once
+
+#include "matrix.h"
+#include "solve_error.h"
+#include "sparse_matrix.h"
+#include "sparse_vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace jsolve
+{
+
+struct LuParameters
+{
+    double pivot_threshold{0.1};  // Threshold test, a pivot must satisfy |a_ij| >= u * max_k |a_kj|
+    double pivot_tolerance{1e-9}; // Absolute minimum pivot magnitude
+    std::size_t search_limit{4};  // Rows/cols to examine once a pivot candidate has been found
+    double hyper_density{0.1};    // Solves use a symbolic (reachability) pass below this density
+    double drop_tolerance{1e-14}; // Solve results smaller than this are treated as cancellation and dropped
+};
+
+struct LuStats
+{
+    std::size_t basis_nonzeros{0}; // Non-zeros in the factored matrix
+    std::size_t l_nonzeros{0};     // Off-diagonal non-zeros in L
+    std::size_t u_nonzeros{0};     // Non-zeros in U, including the diagonal
+    std::size_t n_singletons{0};   // Pivots with a Markowitz count of zero (no elimination work)
+    std::size_t r_nonzeros{0};     // Non-zeros in the Forrest-Tomlin row etas
+    std::size_t n_updates{0};      // Column replacements since the factorisation
+
+    std::ptrdiff_t fill_in() const
+    {
+        return static_cast<std::ptrdiff_t>(l_nonzeros + u_nonzeros) - static_cast<std::ptrdiff_t>(basis_nonzeros);
+    }
+};
+
+template <typename T>
+class SparseLU
+{
+    // Sparse LU factorisation of a square matrix B, giving L * B = U up to row and column permutations.
+    // Pivots are chosen to minimise the Markowitz count (r - 1) * (c - 1), subject to a threshold test
+    // on the pivot magnitude relative to the largest entry in its column.
+    // Described in "Computational Techniques of the Simplex Method" (Maros, 2003) p136 and
+    // "Direct Methods for Sparse Matrices" (Duff, Erisman & Reid, 2017) ch. 10.
+    // L is held as a sequence of column etas. U is held as row-wise and column-wise lists of
+    // off-diagonal entries, where rows are rows of B and columns are columns (basis positions) of B.
+    // Column replacements use the Forrest-Tomlin update, which keeps U triangular (up to a change of
+    // pivot order) and appends a row eta R per update, giving R_k ... R_1 * L * B = U.
+    // Described in (Forrest & Tomlin, 1972) and (Maros, 2003) p146.
+    // Solves with a sparse right-hand side first find the entries that can become non-zero, by a depth
+    // first search over the structure of L and U, and only visit those (Gilbert & Peierls, 1988).
+    // The search and the solves use scratch space held by the factorisation, so solves must not run concurrently.
+    // Scratch vectors are cleared through their lists of non-zeros, so a solve into a caller's buffer only touches
+    // the entries it reaches.
+
+  public:
+    explicit SparseLU(const SparseMatrix<T>& B, LuParameters params = {});
+    explicit SparseLU(const SparseMatrix<T>& A, std::span<const std::size_t> columns, LuParameters params = {});
+
+    std::size_t size() const;
+    const LuStats& stats() const;
+
+    // Solves B * x = b. If spike is given, it receives the partially transformed b needed by update().
+    SparseVector<T> solve(const SparseVector<T>& b, SparseVector<T>* spike = nullptr) const;
+    Matrix<T> solve(const Matrix<T>& b) const;
+
+    // Solves B * x = b into x, of size(), replacing what it held. x must not be b.
+    void solve(const SparseVector<T>& b, SparseVector<T>& x, SparseVector<T>* spike = nullptr) const;
+
+    // Solves trans(B) * x = b
+    SparseVector<T> transpose_solve(const SparseVector<T>& b) const;
+    Matrix<T> transpose_solve(const Matrix<T>& b) const;
+
+    // Solves trans(B) * x = b into x, of size(), replacing what it held. x must not be b.
+    void transpose_solve(const SparseVector<T>& b, SparseVector<T>& x) const;
+
+    // Replaces column col of B, given the spike of the new column from solve() and the pivot x(col) of
+    // the same solve. Returns false if the update was numerically unstable, the caller should refactor.
+    bool update(std::size_t col, const SparseVector<T>& spike, T pivot);
+
+  private:
+    static constexpr std::size_t npos{std::numeric_limits<std::size_t>::max()};
+
+    struct Entry
+    {
+        std::size_t index{0};
+        T value{0};
+    };
+
+    class CountLists
+    {
+        // Doubly linked lists of items (rows or cols) bucketed by their count of active entries.
+
+      public:
+        explicit CountLists(std::size_t n)
+            : m_head(n + 1, npos),
+              m_next(n, npos),
+              m_prev(n, npos),
+              m_count(n, 0)
+        {
+        }
+
+        void insert(std::size_t item, std::size_t count)
+        {
+            m_count[item] = count;
+            m_prev[item] = npos;
+            m_next[item] = m_head[count];
+            if (m_head[count] != npos)
+            {
+                m_prev[m_head[count]] = item;
+            }
+            m_head[count] = item;
+        }
+
+        void remove(std::size_t item)
+        {
+            if (m_prev[item] != npos)
+            {
+                m_next[m_prev[item]] = m_next[item];
+            }
+            else
+            {
+                m_head[m_count[item]] = m_next[item];
+            }
+
+            if (m_next[item] != npos)
+            {
+                m_prev[m_next[item]] = m_prev[item];
+            }
+        }
+
+        void move(std::size_t item, std::size_t count)
+        {
+            remove(item);
+            insert(item, count);
+        }
+
+        std::size_t first(std::size_t count) const
+        {
+            return m_head[count];
+        }
+
+        std::size_t next(std::size_t item) const
+        {
+            return m_next[item];
+        }
+
+      private:
+        std::vector<std::size_t> m_head;
+        std::vector<std::size_t> m_next;
+        std::vector<std::size_t> m_prev;
+        std::vector<std::size_t> m_count;
+    };
+
+    void factor(const SparseMatrix<T>& A, std::span<const std::size_t> columns);
+
+    // Finds the nodes reachable from the non-zeros of x in the graph given by neighbours, in topological
+    // order in m_reached. Returns false if x or the result is too dense for this to be worthwhile.
+    template <typename Neighbours>
+    bool reach(const SparseVector<T>& x, Neighbours neighbours) const;
+
+    LuParameters m_params;
+    LuStats m_stats;
+    std::size_t m_size{0};
+
+    // Pivots, indexed by elimination step
+    std::vector<std::size_t> m_pivot_row;
+    std::vector<std::size_t> m_pivot_col;
+    std::vector<T> m_diag;
+    std::vector<std::size_t> m_order;     // Pivots in triangular order of U
+    std::vector<std::size_t> m_position;  // Pivot -> position in m_order
+    std::vector<std::size_t> m_col_pivot; // Column of B -> pivot
+    std::vector<std::size_t> m_row_pivot; // Row of B -> pivot
+
+    // L etas: eta e eliminates rows in m_l_entries[m_l_start[e]..m_l_start[e + 1]) using row m_l_row[e]
+    std::vector<std::size_t> m_l_row;
+    std::vector<std::size_t> m_l_start;
+    std::vector<Entry> m_l_entries;
+    std::vector<std::size_t> m_row_eta; // Row of B -> L eta pivoting on it
+
+    // L etas stored by row: m_lt_entries[m_lt_start[row]..m_lt_start[row + 1]) holds (eta pivot row, value)
+    std::vector<std::size_t> m_lt_start;
+    std::vector<Entry> m_lt_entries;
+
+    // U off-diagonals: m_u_rows[row] holds (col, value), m_u_cols[col] holds (row, value)
+    std::vector<std::vector<Entry>> m_u_rows;
+    std::vector<std::vector<Entry>> m_u_cols;
+
+    // R etas: eta e subtracts multiples of rows in m_r_entries[m_r_start[e]..m_r_start[e + 1]) from row m_r_row[e]
+    std::vector<std::size_t> m_r_row;
+    std::vector<std::size_t> m_r_start;
+    std::vector<Entry> m_r_entries;
+
+    std::vector<T> m_work; // Dense row of U, indexed by column, used by update()
+
+    // Depth first search scratch space, used by reach()
+    mutable std::vector<char> m_visited;
+    mutable std::vector<std::pair<std::size_t, std::size_t>> m_stack;
+    mutable std::vector<std::size_t> m_reached;
+
+    // Right-hand side being transformed by solve() and transpose_solve()
+    mutable SparseVector<T> m_rhs{0};
+};
+
+template <typename T>
+SparseLU<T>::SparseLU(const SparseMatrix<T>& B, LuParameters params)
+    : m_params{params}
+{
+    std::vector<std::size_t> columns(B.n_cols());
+    std::iota(std::begin(columns), std::end(columns), 0);
+    factor(B, columns);
+}
+
+template <typename T>
+SparseLU<T>::SparseLU(const SparseMatrix<T>& A, std::span<const std::size_t> columns, LuParameters params)
+    : m_params{params}
+{
+    // Factor the square matrix formed by the given columns of A.
+    factor(A, columns);
+}
+
+template <typename T>
+std::size_t SparseLU<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+const LuStats& SparseLU<T>::stats() const
+{
+    return m_stats;
+}
+
+template <typename T>
+void SparseLU<T>::factor(const SparseMatrix<T>& A, std::span<const std::size_t> columns)
+{
+    const auto m = A.n_rows();
+
+    if (columns.size() != m)
+    {
+        throw SolveError("Cannot factor non-square matrix");
+    }
+
+    m_size = m;
+    m_stats = {};
+
+    // Active submatrix: values held column-wise, pattern only held row-wise
+    std::vector<std::vector<Entry>> active_cols(m);
+    std::vector<std::vector<std::size_t>> active_rows(m);
+
+    for (std::size_t j{0}; j < m; j++)
+    {
+        auto rows = A.col_indices(columns[j]);
+        auto values = A.col_values(columns[j]);
+
+        active_cols[j].reserve(rows.size());
+        for (std::size_t pos{0}; pos < rows.size(); pos++)
+        {
+            active_cols[j].push_back({rows[pos], values[pos]});
+            active_rows[rows[pos]].push_back(j);
+        }
+
+        m_stats.basis_nonzeros += rows.size();
+    }
+
+    CountLists col_lists{m};
+    CountLists row_lists{m};
+
+    for (std::size_t i{0}; i < m; i++)
+    {
+        col_lists.insert(i, active_cols[i].size());
+        row_lists.insert(i, active_rows[i].size());
+    }
+
+    m_pivot_row.assign(m, npos);
+    m_pivot_col.assign(m, npos);
+    m_diag.assign(m, T{0});
+    m_order.resize(m);
+    std::iota(std::begin(m_order), std::end(m_order), 0);
+
+    m_l_row.clear();
+    m_l_start.assign(1, 0);
+    m_l_entries.clear();
+
+    m_u_rows.assign(m, {});
+    m_u_cols.assign(m, {});
+
+    m_r_row.clear();
+    m_r_start.assign(1, 0);
+    m_r_entries.clear();
+
+    auto col_abs_max = [&active_cols](std::size_t col) {
+        T result{0};
+        for (const auto& entry : active_cols[col])
+        {
+            result = std::max(result, std::abs(entry.value));
+        }
+        return result;
+    };
+
+    auto acceptable = [this](T value, T col_max) {
+        return std::abs(value) >= std::max(T(m_params.pivot_tolerance), T(m_params.pivot_threshold) * col_max);
+    };
+
+    auto find_pivot = [&]() -> std::pair<std::size_t, std::size_t> {
+        // Markowitz search over columns then rows of increasing count.
+
+        std::size_t best_row{npos};
+        std::size_t best_col{npos};
+        std::size_t best_cost{npos};
+        T best_abs{0};
+        std::size_t n_searched{0};
+
+        auto consider = [&](std::size_t row, std::size_t col, T value, std::size_t cost) {
+            if (cost < best_cost || (cost == best_cost && std::abs(value) > best_abs))
+            {
+                best_row = row;
+                best_col = col;
+                best_cost = cost;
+                best_abs = std::abs(value);
+            }
+        };
+
+        for (std::size_t count{1}; count <= m; count++)
+        {
+            for (auto col{col_lists.first(count)}; col != npos; col = col_lists.next(col))
+            {
+                auto col_max = col_abs_max(col);
+                for (const auto& entry : active_cols[col])
+                {
+                    if (acceptable(entry.value, col_max))
+                    {
+                        consider(entry.index, col, entry.value, (active_rows[entry.index].size() - 1) * (count - 1));
+                    }
+                }
+
+                if (best_row != npos &&
+                    (best_cost <= (count - 1) * (count - 1) || ++n_searched >= m_params.search_limit))
+                {
+                    return {best_row, best_col};
+                }
+            }
+
+            for (auto row{row_lists.first(count)}; row != npos; row = row_lists.next(row))
+            {
+                for (const auto col : active_rows[row])
+                {
+                    auto col_max = col_abs_max(col);
+                    for (const auto& entry : active_cols[col])
+                    {
+                        if (entry.index == row && acceptable(entry.value, col_max))
+                        {
+                            consider(row, col, entry.value, (count - 1) * (active_cols[col].size() - 1));
+                        }
+                    }
+                }
+
+                if (best_row != npos && (best_cost <= count * (count - 1) || ++n_searched >= m_params.search_limit))
+                {
+                    return {best_row, best_col};
+                }
+            }
+
+            if (best_row != npos && best_cost <= count * count)
+            {
+                break;
+            }
+        }
+
+        return {best_row, best_col};
+    };
+
+    std::vector<std::size_t> work(m, npos); // Row -> position within the column being updated
+    std::vector<Entry> multipliers;
+
+    for (std::size_t k{0}; k < m; k++)
+    {
+        auto [pivot_row, pivot_col] = find_pivot();
+
+        if (pivot_row == npos)
+        {
+            throw SolveError("LU factor failed, matrix is degenerate");
+        }
+
+        col_lists.remove(pivot_col);
+        row_lists.remove(pivot_row);
+
+        auto& pcol = active_cols[pivot_col];
+
+        if (pcol.size() == 1 || active_rows[pivot_row].size() == 1)
+        {
+            m_stats.n_singletons++;
+        }
+
+        // Multipliers for the L eta, and retire the pivot column from the row patterns
+        T pivot_value{0};
+        for (const auto& entry : pcol)
+        {
+            if (entry.index == pivot_row)
+            {
+                pivot_value = entry.value;
+            }
+        }
+
+        multipliers.clear();
+        for (const auto& entry : pcol)
+        {
+            if (entry.index != pivot_row)
+            {
+                multipliers.push_back({entry.index, entry.value / pivot_value});
+            }
+
+            auto& pattern = active_rows[entry.index];
+            auto found = std::find(std::begin(pattern), std::end(pattern), pivot_col);
+            *found = pattern.back();
+            pattern.pop_back();
+        }
+        std::vector<Entry>{}.swap(pcol);
+
+        m_pivot_row[k] = pivot_row;
+        m_pivot_col[k] = pivot_col;
+        m_diag[k] = pivot_value;
+
+        if (!multipliers.empty())
+        {
+            m_l_row.push_back(pivot_row);
+            m_l_entries.insert(std::end(m_l_entries), std::begin(multipliers), std::end(multipliers));
+            m_l_start.push_back(m_l_entries.size());
+        }
+
+        // The remainder of the pivot row becomes a row of U, and is eliminated from the other rows
+        for (const auto col : active_rows[pivot_row])
+        {
+            auto& active = active_cols[col];
+
+            auto found = std::find_if(std::begin(active), std::end(active), [pivot_row](const auto& entry) {
+                return entry.index == pivot_row;
+            });
+            T u_value{found->value};
+            *found = active.back();
+            active.pop_back();
+
+            m_u_rows[pivot_row].push_back({col, u_value});
+            m_u_cols[col].push_back({pivot_row, u_value});
+
+            if (!multipliers.empty())
+            {
+                for (std::size_t pos{0}; pos < active.size(); pos++)
+                {
+                    work[active[pos].index] = pos;
+                }
+
+                for (const auto& [row, mult] : multipliers)
+                {
+                    if (work[row] != npos)
+                    {
+                        active[work[row]].value -= mult * u_value;
+                    }
+                    else
+                    {
+                        // Fill-in
+                        active.push_back({row, -mult * u_value});
+                        active_rows[row].push_back(col);
+                    }
+                }
+
+                for (const auto& entry : active)
+                {
+                    work[entry.index] = npos;
+                }
+            }
+
+            col_lists.move(col, active.size());
+        }
+        std::vector<std::size_t>{}.swap(active_rows[pivot_row]);
+
+        for (const auto& entry : multipliers)
+        {
+            row_lists.move(entry.index, active_rows[entry.index].size());
+        }
+    }
+
+    m_position = m_order;
+    m_col_pivot.assign(m, npos);
+    m_row_pivot.assign(m, npos);
+    for (std::size_t k{0}; k < m; k++)
+    {
+        m_col_pivot[m_pivot_col[k]] = k;
+        m_row_pivot[m_pivot_row[k]] = k;
+    }
+
+    // Row-wise copy of L, for the transposed solve
+    m_row_eta.assign(m, npos);
+    m_lt_start.assign(m + 1, 0);
+    for (std::size_t eta{0}; eta < m_l_row.size(); eta++)
+    {
+        m_row_eta[m_l_row[eta]] = eta;
+        for (auto pos{m_l_start[eta]}; pos < m_l_start[eta + 1]; pos++)
+        {
+            m_lt_start[m_l_entries[pos].index + 1]++;
+        }
+    }
+    std::partial_sum(std::begin(m_lt_start), std::end(m_lt_start), std::begin(m_lt_start));
+
+    m_lt_entries.resize(m_l_entries.size());
+    {
+        auto next{m_lt_start};
+        for (std::size_t eta{0}; eta < m_l_row.size(); eta++)
+        {
+            for (auto pos{m_l_start[eta]}; pos < m_l_start[eta + 1]; pos++)
+            {
+                m_lt_entries[next[m_l_entries[pos].index]++] = {m_l_row[eta], m_l_entries[pos].value};
+            }
+        }
+    }
+
+    m_work.assign(m, T{0});
+    m_visited.assign(m, 0);
+    m_rhs = SparseVector<T>{m};
+
+    m_stats.l_nonzeros = m_l_entries.size();
+    m_stats.u_nonzeros = m;
+    for (const auto& row : m_u_rows)
+    {
+        m_stats.u_nonzeros += row.size();
+    }
+}
+
+template <typename T>
+template <typename Neighbours>
+bool SparseLU<T>::reach(const SparseVector<T>& x, Neighbours neighbours) const
+{
+    // Depth first search from each non-zero, the reverse post-order is a topological order.
+    // (Gilbert & Peierls, 1988), also "Direct Methods for Sparse Linear Systems" (Davis, 2006) p29.
+    // The search stops early once the result passes the density limit, as a plain solve is then cheaper.
+
+    const auto limit = static_cast<std::size_t>(m_params.hyper_density * static_cast<double>(m_size));
+
+    m_reached.clear();
+    m_stack.clear();
+
+    if (x.n_nonzeros() >= limit)
+    {
+        return false;
+    }
+
+    for (const auto node : x.indices())
+    {
+        if (m_visited[node])
+        {
+            continue;
+        }
+
+        m_visited[node] = 1;
+        m_stack.push_back({node, 0});
+
+        while (!m_stack.empty())
+        {
+            auto [current, pos] = m_stack.back();
+            auto adjacent = neighbours(current);
+
+            if (pos < adjacent.size())
+            {
+                m_stack.back().second++;
+
+                const auto next = adjacent[pos].index;
+                if (!m_visited[next])
+                {
+                    m_visited[next] = 1;
+                    m_stack.push_back({next, 0});
+                }
+            }
+            else
+            {
+                m_reached.push_back(current);
+                m_stack.pop_back();
+            }
+
+            if (m_reached.size() + m_stack.size() >= limit)
+            {
+                break;
+            }
+        }
+
+        if (m_reached.size() + m_stack.size() >= limit)
+        {
+            break;
+        }
+    }
+
+    for (const auto node : m_reached)
+    {
+        m_visited[node] = 0;
+    }
+
+    if (!m_stack.empty())
+    {
+        for (const auto& [node, pos] : m_stack)
+        {
+            m_visited[node] = 0;
+        }
+        m_stack.clear();
+        return false;
+    }
+
+    if (m_reached.size() >= limit)
+    {
+        return false;
+    }
+
+    std::reverse(std::begin(m_reached), std::end(m_reached));
+    return true;
+}
+
+template <typename T>
+SparseVector<T> SparseLU<T>::solve(const SparseVector<T>& b, SparseVector<T>* spike) const
+{
+    SparseVector<T> x{m_size};
+    solve(b, x, spike);
+    return x;
+}
+
+template <typename T>
+void SparseLU<T>::solve(const SparseVector<T>& b, SparseVector<T>& x, SparseVector<T>* spike) const
+{
+    // FTRAN: apply the L and R etas to b, then backward solve with U in reverse pivot order.
+    // The result is indexed by the columns (basis positions) of B.
+
+    if (b.size() != m_size || x.size() != m_size)
+    {
+        throw SolveError("Input b must be a column with one entry per row of B");
+    }
+
+    auto& y = m_rhs;
+    y.assign(b);
+
+    auto apply_l = [this, &y](std::size_t eta) {
+        const auto pivot_value = y[m_l_row[eta]];
+
+        if (pivot_value != T{0})
+        {
+            for (auto pos{m_l_start[eta]}; pos < m_l_start[eta + 1]; pos++)
+            {
+                y.add(m_l_entries[pos].index, -m_l_entries[pos].value * pivot_value);
+            }
+        }
+    };
+
+    auto l_eta = [this](std::size_t row) -> std::span<const Entry> {
+        const auto eta = m_row_eta[row];
+        if (eta == npos)
+        {
+            return {};
+        }
+        return {m_l_entries.data() + m_l_start[eta], m_l_start[eta + 1] - m_l_start[eta]};
+    };
+
+    if (reach(y, l_eta))
+    {
+        for (const auto row : m_reached)
+        {
+            if (m_row_eta[row] != npos)
+            {
+                apply_l(m_row_eta[row]);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t eta{0}; eta < m_l_row.size(); eta++)
+        {
+            apply_l(eta);
+        }
+    }
+
+    for (std::size_t eta{0}; eta < m_r_row.size(); eta++)
+    {
+        T sum{0};
+        for (auto pos{m_r_start[eta]}; pos < m_r_start[eta + 1]; pos++)
+        {
+            sum += m_r_entries[pos].value * y[m_r_entries[pos].index];
+        }
+
+        if (sum != T{0})
+        {
+            y.add(m_r_row[eta], -sum);
+        }
+    }
+
+    if (spike)
+    {
+        spike->assign(y);
+    }
+
+    x.clear();
+
+    auto apply_u = [this, &x, &y](std::size_t pivot) {
+        const auto col = m_pivot_col[pivot];
+        const auto x_col = y[m_pivot_row[pivot]] / m_diag[pivot];
+
+        if (x_col != T{0})
+        {
+            x.set(col, x_col);
+
+            for (const auto& [row, value] : m_u_cols[col])
+            {
+                y.add(row, -value * x_col);
+            }
+        }
+    };
+
+    auto u_col = [this](std::size_t row) -> std::span<const Entry> {
+        return m_u_cols[m_pivot_col[m_row_pivot[row]]];
+    };
+
+    if (reach(y, u_col))
+    {
+        for (const auto row : m_reached)
+        {
+            apply_u(m_row_pivot[row]);
+        }
+    }
+    else
+    {
+        for (auto it = std::rbegin(m_order); it != std::rend(m_order); ++it)
+        {
+            apply_u(*it);
+        }
+    }
+
+    x.prune(T(m_params.drop_tolerance));
+}
+
+template <typename T>
+Matrix<T> SparseLU<T>::solve(const Matrix<T>& b) const
+{
+    if (b.n_rows() != m_size || b.n_cols() != 1)
+    {
+        throw SolveError("Input b must be a column with one entry per row of B");
+    }
+
+    return solve(SparseVector<T>{b}).make_dense();
+}
+
+template <typename T>
+SparseVector<T> SparseLU<T>::transpose_solve(const SparseVector<T>& b) const
+{
+    SparseVector<T> x{m_size};
+    transpose_solve(b, x);
+    return x;
+}
+
+template <typename T>
+void SparseLU<T>::transpose_solve(const SparseVector<T>& b, SparseVector<T>& w) const
+{
+    // BTRAN: forward solve with trans(U) in pivot order, then apply the transposed R and L etas in reverse.
+    // The input is indexed by the columns (basis positions) of B, the result by the rows of B.
+
+    if (b.size() != m_size || w.size() != m_size)
+    {
+        throw SolveError("Input b must be a column with one entry per column of B");
+    }
+
+    auto& d = m_rhs;
+    d.assign(b);
+    w.clear();
+
+    auto apply_u = [this, &d, &w](std::size_t pivot) {
+        const auto row = m_pivot_row[pivot];
+        const auto w_row = d[m_pivot_col[pivot]] / m_diag[pivot];
+
+        if (w_row != T{0})
+        {
+            w.set(row, w_row);
+
+            for (const auto& [col, value] : m_u_rows[row])
+            {
+                d.add(col, -value * w_row);
+            }
+        }
+    };
+
+    auto u_row = [this](std::size_t col) -> std::span<const Entry> {
+        return m_u_rows[m_pivot_row[m_col_pivot[col]]];
+    };
+
+    if (reach(d, u_row))
+    {
+        for (const auto col : m_reached)
+        {
+            apply_u(m_col_pivot[col]);
+        }
+    }
+    else
+    {
+        for (const auto pivot : m_order)
+        {
+            apply_u(pivot);
+        }
+    }
+
+    for (auto eta{m_r_row.size()}; eta-- > 0;)
+    {
+        const auto pivot_value = w[m_r_row[eta]];
+
+        if (pivot_value != T{0})
+        {
+            for (auto pos{m_r_start[eta]}; pos < m_r_start[eta + 1]; pos++)
+            {
+                w.add(m_r_entries[pos].index, -m_r_entries[pos].value * pivot_value);
+            }
+        }
+    }
+
+    // Row-wise L, each row is final once the etas pivoting on it have been applied
+    auto lt_row = [this](std::size_t row) -> std::span<const Entry> {
+        return {m_lt_entries.data() + m_lt_start[row], m_lt_start[row + 1] - m_lt_start[row]};
+    };
+
+    if (reach(w, lt_row))
+    {
+        for (const auto row : m_reached)
+        {
+            const auto w_row = w[row];
+
+            if (w_row != T{0})
+            {
+                for (const auto& [pivot_row, value] : lt_row(row))
+                {
+                    w.add(pivot_row, -value * w_row);
+                }
+            }
+        }
+    }
+    else
+    {
+        for (auto eta{m_l_row.size()}; eta-- > 0;)
+        {
+            T sum{0};
+            for (auto pos{m_l_start[eta]}; pos < m_l_start[eta + 1]; pos++)
+            {
+                sum += m_l_entries[pos].value * w[m_l_entries[pos].index];
+            }
+
+            if (sum != T{0})
+            {
+                w.add(m_l_row[eta], -sum);
+            }
+        }
+    }
+
+    w.prune(T(m_params.drop_tolerance));
+}
+
+template <typename T>
+Matrix<T> SparseLU<T>::transpose_solve(const Matrix<T>& b) const
+{
+    if (b.n_rows() != m_size || b.n_cols() != 1)
+    {
+        throw SolveError("Input b must be a column with one entry per column of B");
+    }
+
+    return transpose_solve(SparseVector<T>{b}).make_dense();
+}
+
+template <typename T>
+bool SparseLU<T>::update(std::size_t col, const SparseVector<T>& spike, T pivot)
+{
+    // Forrest-Tomlin update (Maros, 2003) p146.
+    // The spike (L and R applied to the entering column) replaces column col of U. The row of the
+    // pivot owning col is then eliminated using the rows that follow it in pivot order, which are
+    // recorded as a new R eta, and the pivot moves to the end of the order so U stays triangular.
+
+    if (col >= m_size || spike.size() != m_size)
+    {
+        throw SolveError("Invalid column replacement");
+    }
+
+    const auto t = m_col_pivot[col];
+    const auto row_t = m_pivot_row[t];
+    const auto old_diag = m_diag[t];
+
+    auto remove_entry = [](std::vector<Entry>& entries, std::size_t index) {
+        auto found = std::find_if(std::begin(entries), std::end(entries), [index](const auto& entry) {
+            return entry.index == index;
+        });
+        *found = entries.back();
+        entries.pop_back();
+    };
+
+    // Drop the old column
+    for (const auto& entry : m_u_cols[col])
+    {
+        remove_entry(m_u_rows[entry.index], col);
+    }
+    m_stats.u_nonzeros -= m_u_cols[col].size();
+    m_u_cols[col].clear();
+
+    // Move the pivot row into the work vector, then eliminate it in pivot order
+    for (const auto& entry : m_u_rows[row_t])
+    {
+        m_work[entry.index] = entry.value;
+        remove_entry(m_u_cols[entry.index], row_t);
+    }
+    m_stats.u_nonzeros -= m_u_rows[row_t].size();
+    m_u_rows[row_t].clear();
+
+    T new_diag{spike[row_t]};
+    const auto eta_start = m_r_entries.size();
+
+    for (auto pos{m_position[t] + 1}; pos < m_size; pos++)
+    {
+        const auto k = m_order[pos];
+        const auto w_col = m_work[m_pivot_col[k]];
+
+        if (w_col == T{0})
+        {
+            continue;
+        }
+
+        const auto mult = w_col / m_diag[k];
+        m_work[m_pivot_col[k]] = T{0};
+
+        for (const auto& entry : m_u_rows[m_pivot_row[k]])
+        {
+            m_work[entry.index] -= mult * entry.value;
+        }
+
+        new_diag -= mult * spike[m_pivot_row[k]];
+
+        m_r_entries.push_back({m_pivot_row[k], mult});
+    }
+
+    if (m_r_entries.size() > eta_start)
+    {
+        m_r_row.push_back(row_t);
+        m_r_start.push_back(m_r_entries.size());
+        m_stats.r_nonzeros += m_r_entries.size() - eta_start;
+    }
+
+    // The spike becomes the new column, with its entry in the pivot row as the diagonal
+    for (const auto row : spike.indices())
+    {
+        if (row != row_t && spike[row] != T{0})
+        {
+            m_u_cols[col].push_back({row, spike[row]});
+            m_u_rows[row].push_back({col, spike[row]});
+        }
+    }
+    m_stats.u_nonzeros += m_u_cols[col].size();
+
+    m_diag[t] = new_diag;
+
+    for (auto pos{m_position[t] + 1}; pos < m_size; pos++)
+    {
+        m_order[pos - 1] = m_order[pos];
+        m_position[m_order[pos - 1]] = pos - 1;
+    }
+    m_order.back() = t;
+    m_position[t] = m_size - 1;
+
+    m_stats.n_updates++;
+
+    // The new diagonal should equal pivot * old diagonal, a large difference signals lost accuracy
+    const auto expected_diag = pivot * old_diag;
+    return std::abs(new_diag) >= m_params.pivot_tolerance &&
+           std::abs(new_diag - expected_diag) <= 1e-8 * std::max(T{1}, std::abs(new_diag));
+}
+
+} // namespace jsolve
@@ -0,0 +1,601 @@
+#pragma once
+
+#include "matrix.h"
+#include "sparse_vector.h"
+
+#include "logging.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <vector>
+
+template <typename T>
+class SparseMatrix
+{
+    // Sparse matrix holding both compressed column (CSC) and compressed row (CSR) copies of the entries.
+    // Memory scales with the number of non-zeros rather than rows * cols.
+    // Entries are sorted by row within each column, and by column within each row.
+    // set_column only changes the CSC copy, call refresh_rows() after a run of them before reading the rows again.
+    // Reads never modify the matrix, so a const matrix can be shared between threads.
+
+  public:
+    typedef T value_type;
+
+    struct Entry
+    {
+        std::size_t row{0};
+        std::size_t col{0};
+        T value{0};
+    };
+
+    explicit SparseMatrix(std::size_t r, std::size_t c);
+    explicit SparseMatrix(std::size_t r, std::size_t c, const std::vector<Entry>& entries);
+    explicit SparseMatrix(const Matrix<T>& dense);
+
+    std::size_t n_rows() const;
+    std::size_t n_cols() const;
+    std::size_t n_nonzeros() const;
+
+    SparseMatrix make_transpose() const;
+    Matrix<T> make_dense() const;
+
+    // Compressed column access
+    std::span<const std::size_t> col_indices(std::size_t col) const;
+    std::span<const T> col_values(std::size_t col) const;
+    Matrix<T> column(std::size_t col) const;
+    SparseVector<T> sparse_column(std::size_t col) const;
+
+    // Compressed row access, the rows must be current
+    std::span<const std::size_t> row_indices(std::size_t row) const;
+    std::span<const T> row_values(std::size_t row) const;
+
+    void set_column(std::size_t col, const SparseMatrix& source, std::size_t source_col);
+    void refresh_rows();
+
+    void scale_rows(const std::vector<T>& factors);
+    void scale_cols(const std::vector<T>& factors);
+
+    Matrix<T> transpose_multiply(const Matrix<T>& x) const;
+    Matrix<T> transpose_multiply(const SparseVector<T>& x) const;
+
+    // Operators -------------------------------------------------------------------------------
+
+    // Access (returns zero for entries that are not stored)
+    T operator()(const std::size_t row, const std::size_t col) const;
+
+    // Put-to
+    template <typename U>
+    friend std::ostream& operator<<(std::ostream& os, const SparseMatrix<U>& m);
+
+    // Comparison
+    template <typename U>
+    friend bool operator==(const SparseMatrix<U>& lhs, const SparseMatrix<U>& rhs);
+
+  private:
+    void build_rows();
+
+    std::size_t m_n_rows{0};
+    std::size_t m_n_cols{0};
+
+    // Entries of column j are at [m_col_start[j], m_col_start[j + 1])
+    std::vector<std::size_t> m_col_start;
+    std::vector<std::size_t> m_col_index; // Row of each entry
+    std::vector<T> m_col_value;
+
+    // Entries of row i are at [m_row_start[i], m_row_start[i + 1]), out of date while m_rows_stale
+    std::vector<std::size_t> m_row_start;
+    std::vector<std::size_t> m_row_index; // Col of each entry
+    std::vector<T> m_row_value;
+    bool m_rows_stale{false};
+};
+
+// SparseMatrix:: member functions
+template <typename T>
+SparseMatrix<T>::SparseMatrix(std::size_t r, std::size_t c)
+    : m_n_rows{r},
+      m_n_cols{c},
+      m_col_start(c + 1, 0),
+      m_row_start(r + 1, 0)
+{
+    if ((r == 0) || (c == 0))
+    {
+        throw MatrixError("Cannot construct matrix with zero row/col count");
+    }
+}
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(std::size_t r, std::size_t c, const std::vector<Entry>& entries)
+    : SparseMatrix(r, c)
+{
+    // Builds the matrix from (row, col, value) triplets in any order.
+    // Duplicate entries are summed and explicit zeros are dropped.
+
+    // Bucket the triplets by row (counting sort)
+    std::vector<std::size_t> row_start(m_n_rows + 1, 0);
+
+    for (const auto& entry : entries)
+    {
+        if (entry.row >= m_n_rows || entry.col >= m_n_cols)
+        {
+            throw MatrixError(fmt::format("Entry ({}, {}) outside of {}x{} matrix", entry.row, entry.col, r, c));
+        }
+        row_start[entry.row + 1]++;
+    }
+
+    std::partial_sum(std::begin(row_start), std::end(row_start), std::begin(row_start));
+
+    std::vector<std::size_t> row_col(entries.size());
+    std::vector<T> row_value(entries.size());
+    {
+        auto next{row_start};
+        for (const auto& entry : entries)
+        {
+            auto pos = next[entry.row]++;
+            row_col[pos] = entry.col;
+            row_value[pos] = entry.value;
+        }
+    }
+
+    // Bucket by column, visiting rows in order so each column ends up sorted by row
+    for (const auto col : row_col)
+    {
+        m_col_start[col + 1]++;
+    }
+
+    std::partial_sum(std::begin(m_col_start), std::end(m_col_start), std::begin(m_col_start));
+
+    m_col_index.resize(entries.size());
+    m_col_value.resize(entries.size());
+    {
+        auto next{m_col_start};
+        for (std::size_t row{0}; row < m_n_rows; row++)
+        {
+            for (auto pos{row_start[row]}; pos < row_start[row + 1]; pos++)
+            {
+                auto dest = next[row_col[pos]]++;
+                m_col_index[dest] = row;
+                m_col_value[dest] = row_value[pos];
+            }
+        }
+    }
+
+    // Merge duplicates (now adjacent) and drop zeros
+    std::size_t n_kept{0};
+    std::size_t col_begin{0};
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        auto col_end = m_col_start[col + 1];
+        m_col_start[col] = n_kept;
+
+        for (auto pos{col_begin}; pos < col_end; pos++)
+        {
+            if (n_kept > m_col_start[col] && m_col_index[n_kept - 1] == m_col_index[pos])
+            {
+                m_col_value[n_kept - 1] += m_col_value[pos];
+            }
+            else
+            {
+                m_col_index[n_kept] = m_col_index[pos];
+                m_col_value[n_kept] = m_col_value[pos];
+                n_kept++;
+            }
+
+            if (m_col_value[n_kept - 1] == T{0})
+            {
+                n_kept--;
+            }
+        }
+
+        col_begin = col_end;
+    }
+    m_col_start[m_n_cols] = n_kept;
+
+    m_col_index.resize(n_kept);
+    m_col_value.resize(n_kept);
+
+    build_rows();
+}
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(const Matrix<T>& dense)
+    : SparseMatrix(dense.n_rows(), dense.n_cols())
+{
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        for (std::size_t row{0}; row < m_n_rows; row++)
+        {
+            if (dense(row, col) != T{0})
+            {
+                m_col_index.push_back(row);
+                m_col_value.push_back(dense(row, col));
+            }
+        }
+        m_col_start[col + 1] = m_col_index.size();
+    }
+
+    build_rows();
+}
+
+template <typename T>
+void SparseMatrix<T>::build_rows()
+{
+    // Rebuild the CSR copy from the CSC copy.
+
+    m_row_start.assign(m_n_rows + 1, 0);
+
+    for (const auto row : m_col_index)
+    {
+        m_row_start[row + 1]++;
+    }
+
+    std::partial_sum(std::begin(m_row_start), std::end(m_row_start), std::begin(m_row_start));
+
+    m_row_index.resize(m_col_index.size());
+    m_row_value.resize(m_col_value.size());
+
+    auto next{m_row_start};
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        for (auto pos{m_col_start[col]}; pos < m_col_start[col + 1]; pos++)
+        {
+            auto dest = next[m_col_index[pos]]++;
+            m_row_index[dest] = col;
+            m_row_value[dest] = m_col_value[pos];
+        }
+    }
+
+    m_rows_stale = false;
+}
+
+template <typename T>
+std::size_t SparseMatrix<T>::n_rows() const
+{
+    return m_n_rows;
+}
+
+template <typename T>
+std::size_t SparseMatrix<T>::n_cols() const
+{
+    return m_n_cols;
+}
+
+template <typename T>
+std::size_t SparseMatrix<T>::n_nonzeros() const
+{
+    return m_col_value.size();
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::make_transpose() const
+{
+    // The CSR of a matrix is the CSC of its transpose, so this is just a swap of the two copies.
+
+    assert(!m_rows_stale);
+
+    SparseMatrix result{n_cols(), n_rows()};
+
+    result.m_col_start = m_row_start;
+    result.m_col_index = m_row_index;
+    result.m_col_value = m_row_value;
+
+    result.m_row_start = m_col_start;
+    result.m_row_index = m_col_index;
+    result.m_row_value = m_col_value;
+
+    return result;
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::make_dense() const
+{
+    Matrix<T> result{n_rows(), n_cols(), T{0}};
+
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        for (auto pos{m_col_start[col]}; pos < m_col_start[col + 1]; pos++)
+        {
+            result(m_col_index[pos], col) = m_col_value[pos];
+        }
+    }
+
+    return result;
+}
+
+template <typename T>
+std::span<const std::size_t> SparseMatrix<T>::col_indices(std::size_t col) const
+{
+    return {m_col_index.data() + m_col_start[col], m_col_start[col + 1] - m_col_start[col]};
+}
+
+template <typename T>
+std::span<const T> SparseMatrix<T>::col_values(std::size_t col) const
+{
+    return {m_col_value.data() + m_col_start[col], m_col_start[col + 1] - m_col_start[col]};
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::column(std::size_t col) const
+{
+    // Returns a single column as a dense (n_rows x 1) matrix.
+
+    if (col >= n_cols())
+    {
+        throw MatrixError(fmt::format("Column {} out of range for matrix with {} cols", col, n_cols()));
+    }
+
+    Matrix<T> result{n_rows(), 1, T{0}};
+
+    for (auto pos{m_col_start[col]}; pos < m_col_start[col + 1]; pos++)
+    {
+        result(m_col_index[pos], 0) = m_col_value[pos];
+    }
+
+    return result;
+}
+
+template <typename T>
+SparseVector<T> SparseMatrix<T>::sparse_column(std::size_t col) const
+{
+    // Returns a single column as a sparse vector.
+
+    return SparseVector<T>{n_rows(), col_indices(col), col_values(col)};
+}
+
+template <typename T>
+std::span<const std::size_t> SparseMatrix<T>::row_indices(std::size_t row) const
+{
+    assert(!m_rows_stale);
+    return {m_row_index.data() + m_row_start[row], m_row_start[row + 1] - m_row_start[row]};
+}
+
+template <typename T>
+std::span<const T> SparseMatrix<T>::row_values(std::size_t row) const
+{
+    assert(!m_rows_stale);
+    return {m_row_value.data() + m_row_start[row], m_row_start[row + 1] - m_row_start[row]};
+}
+
+template <typename T>
+void SparseMatrix<T>::set_column(std::size_t col, const SparseMatrix& source, std::size_t source_col)
+{
+    // Replace column col with column source_col of source. Only the CSC copy is changed here, so a run of
+    // replacements costs the entries moved in the columns rather than a rebuild of the rows each time.
+    // The rows are out of date until refresh_rows().
+
+    if (col >= n_cols() || source_col >= source.n_cols())
+    {
+        throw MatrixError("Column out of range");
+    }
+
+    if (n_rows() != source.n_rows())
+    {
+        throw MatrixError(
+            fmt::format("Cannot set column of {} rows from a matrix of {} rows", n_rows(), source.n_rows())
+        );
+    }
+
+    auto new_indices = source.col_indices(source_col);
+    auto new_values = source.col_values(source_col);
+
+    auto begin = static_cast<std::ptrdiff_t>(m_col_start[col]);
+    auto end = static_cast<std::ptrdiff_t>(m_col_start[col + 1]);
+
+    m_col_index.erase(std::begin(m_col_index) + begin, std::begin(m_col_index) + end);
+    m_col_value.erase(std::begin(m_col_value) + begin, std::begin(m_col_value) + end);
+
+    m_col_index.insert(std::begin(m_col_index) + begin, std::begin(new_indices), std::end(new_indices));
+    m_col_value.insert(std::begin(m_col_value) + begin, std::begin(new_values), std::end(new_values));
+
+    auto shift = static_cast<std::ptrdiff_t>(new_indices.size()) - (end - begin);
+    for (auto j{col + 1}; j <= m_n_cols; j++)
+    {
+        m_col_start[j] = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(m_col_start[j]) + shift);
+    }
+
+    m_rows_stale = true;
+}
+
+template <typename T>
+void SparseMatrix<T>::refresh_rows()
+{
+    // Rebuild the CSR copy if set_column has changed the columns since it was built.
+
+    if (m_rows_stale)
+    {
+        build_rows();
+    }
+}
+
+template <typename T>
+void SparseMatrix<T>::scale_rows(const std::vector<T>& factors)
+{
+    // Multiply each row i by factors[i].
+
+    if (factors.size() != n_rows())
+    {
+        throw MatrixError("Row scale factors must match the row count");
+    }
+
+    refresh_rows();
+
+    for (std::size_t pos{0}; pos < m_col_value.size(); pos++)
+    {
+        m_col_value[pos] *= factors[m_col_index[pos]];
+    }
+
+    for (std::size_t row{0}; row < m_n_rows; row++)
+    {
+        for (auto pos{m_row_start[row]}; pos < m_row_start[row + 1]; pos++)
+        {
+            m_row_value[pos] *= factors[row];
+        }
+    }
+}
+
+template <typename T>
+void SparseMatrix<T>::scale_cols(const std::vector<T>& factors)
+{
+    // Multiply each column j by factors[j].
+
+    if (factors.size() != n_cols())
+    {
+        throw MatrixError("Col scale factors must match the col count");
+    }
+
+    refresh_rows();
+
+    for (std::size_t pos{0}; pos < m_row_value.size(); pos++)
+    {
+        m_row_value[pos] *= factors[m_row_index[pos]];
+    }
+
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        for (auto pos{m_col_start[col]}; pos < m_col_start[col + 1]; pos++)
+        {
+            m_col_value[pos] *= factors[col];
+        }
+    }
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::transpose_multiply(const Matrix<T>& x) const
+{
+    // Computes trans(this) * x, where x is a dense column, without forming the transpose.
+
+    if (x.n_rows() != n_rows() || x.n_cols() != 1)
+    {
+        throw MatrixError(
+            fmt::format("Cannot multiply transpose of {}x{} by {}x{}", n_rows(), n_cols(), x.n_rows(), x.n_cols())
+        );
+    }
+
+    Matrix<T> result{n_cols(), 1, T{0}};
+
+    for (std::size_t col{0}; col < m_n_cols; col++)
+    {
+        T sum{0};
+        for (auto pos{m_col_start[col]}; pos < m_col_start[col + 1]; pos++)
+        {
+            sum += m_col_value[pos] * x(m_col_index[pos], 0);
+        }
+        result(col, 0) = sum;
+    }
+
+    return result;
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::transpose_multiply(const SparseVector<T>& x) const
+{
+    // Computes trans(this) * x, where x is a sparse column, using the rows matching the non-zeros of x.
+
+    if (x.size() != n_rows())
+    {
+        throw MatrixError(fmt::format("Cannot multiply transpose of {}x{} by {}x1", n_rows(), n_cols(), x.size()));
+    }
+
+    assert(!m_rows_stale);
+
+    Matrix<T> result{n_cols(), 1, T{0}};
+
+    for (const auto row : x.indices())
+    {
+        const auto x_row = x[row];
+        for (auto pos{m_row_start[row]}; pos < m_row_start[row + 1]; pos++)
+        {
+            result(m_row_index[pos], 0) += m_row_value[pos] * x_row;
+        }
+    }
+
+    return result;
+}
+
+template <typename T>
+T SparseMatrix<T>::operator()(const std::size_t row, const std::size_t col) const
+{
+    if (row >= n_rows() || col >= n_cols())
+    {
+        throw MatrixError(fmt::format("Entry ({}, {}) outside of {}x{} matrix", row, col, n_rows(), n_cols()));
+    }
+
+    auto indices = col_indices(col);
+    auto found = std::lower_bound(std::begin(indices), std::end(indices), row);
+
+    if (found != std::end(indices) && *found == row)
+    {
+        return col_values(col)[static_cast<std::size_t>(std::distance(std::begin(indices), found))];
+    }
+
+    return T{0};
+}
+
+// Free functions -----------------------------------------------------------------
+
+template <typename U>
+Matrix<U> operator*(const SparseMatrix<U>& lhs, const Matrix<U>& rhs)
+{
+    // Sparse * dense, visiting only the non-zeros of lhs.
+
+    if (lhs.n_cols() != rhs.n_rows())
+    {
+        throw MatrixError(fmt::format(
+            "Cannot multiply dimensions {}x{} and {}x{}", lhs.n_rows(), lhs.n_cols(), rhs.n_rows(), rhs.n_cols()
+        ));
+    }
+
+    Matrix<U> result{lhs.n_rows(), rhs.n_cols(), U{0}};
+
+    for (std::size_t row{0}; row < lhs.n_rows(); row++)
+    {
+        auto indices = lhs.row_indices(row);
+        auto values = lhs.row_values(row);
+
+        for (std::size_t pos{0}; pos < indices.size(); pos++)
+        {
+            for (std::size_t rhs_col{0}; rhs_col < rhs.n_cols(); rhs_col++)
+            {
+                result(row, rhs_col) += values[pos] * rhs(indices[pos], rhs_col);
+            }
+        }
+    }
+
+    return result;
+}
+
+template <typename U>
+bool operator==(const SparseMatrix<U>& lhs, const SparseMatrix<U>& rhs)
+{
+    return lhs.m_n_rows == rhs.m_n_rows && lhs.m_n_cols == rhs.m_n_cols && lhs.m_col_start == rhs.m_col_start &&
+           lhs.m_col_index == rhs.m_col_index && lhs.m_col_value == rhs.m_col_value;
+}
+
+template <typename U>
+bool operator!=(const SparseMatrix<U>& lhs, const SparseMatrix<U>& rhs)
+{
+    return !operator==(lhs, rhs);
+}
+
+template <typename U>
+std::ostream& operator<<(std::ostream& os, const SparseMatrix<U>& m)
+{
+    // Coordinate format, one entry per line
+
+    os << std::fixed << std::setprecision(4);
+    os << "\n";
+    os << m.n_rows() << "x" << m.n_cols() << " (" << m.n_nonzeros() << " non-zeros)\n";
+
+    for (std::size_t col{0}; col < m.n_cols(); col++)
+    {
+        for (auto pos{m.m_col_start[col]}; pos < m.m_col_start[col + 1]; pos++)
+        {
+            os << "(" << m.m_col_index[pos] << ", " << col << ") " << std::setw(7) << m.m_col_value[pos] << "\n";
+        }
+    }
+
+    return os;
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "matrix.h"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <vector>
+
+template <typename T>
+class SparseVector
+{
+    // Sparse column vector holding a dense array of values plus a list of the positions that have been set.
+    // Reads and writes are O(1) by position, while iteration and clearing only visit the listed positions.
+    // Listed positions may hold a zero if values cancelled, prune() removes these.
+
+  public:
+    typedef T value_type;
+
+    explicit SparseVector(std::size_t size);
+    explicit SparseVector(std::size_t size, std::span<const std::size_t> indices, std::span<const T> values);
+    explicit SparseVector(const Matrix<T>& dense);
+
+    std::size_t size() const;
+    std::size_t n_nonzeros() const;
+    std::span<const std::size_t> indices() const;
+
+    void set(std::size_t i, T value);
+    void add(std::size_t i, T value);
+    void clear();
+
+    // Replace the contents with those of other, of the same size, visiting only the listed positions of both
+    void assign(const SparseVector& other);
+
+    // Remove listed positions whose magnitude is at most tolerance
+    void prune(T tolerance);
+
+    Matrix<T> make_dense() const;
+
+    // Operators -------------------------------------------------------------------------------
+
+    // Access (returns zero for positions that are not listed)
+    T operator[](std::size_t i) const;
+
+    // Put-to
+    template <typename U>
+    friend std::ostream& operator<<(std::ostream& os, const SparseVector<U>& v);
+
+  private:
+    std::vector<T> m_values;
+    std::vector<char> m_listed;
+    std::vector<std::size_t> m_indices;
+};
+
+// SparseVector:: member functions
+template <typename T>
+SparseVector<T>::SparseVector(std::size_t size)
+    : m_values(size, T{0}),
+      m_listed(size, 0)
+{
+}
+
+template <typename T>
+SparseVector<T>::SparseVector(std::size_t size, std::span<const std::size_t> indices, std::span<const T> values)
+    : SparseVector(size)
+{
+    if (indices.size() != values.size())
+    {
+        throw MatrixError("Sparse vector indices and values must be the same length");
+    }
+
+    for (std::size_t pos{0}; pos < indices.size(); pos++)
+    {
+        add(indices[pos], values[pos]);
+    }
+}
+
+template <typename T>
+SparseVector<T>::SparseVector(const Matrix<T>& dense)
+    : SparseVector(dense.n_rows())
+{
+    if (dense.n_cols() != 1)
+    {
+        throw MatrixError("Sparse vector must be constructed from a column");
+    }
+
+    for (std::size_t i{0}; i < dense.n_rows(); i++)
+    {
+        if (dense(i, 0) != T{0})
+        {
+            set(i, dense(i, 0));
+        }
+    }
+}
+
+template <typename T>
+std::size_t SparseVector<T>::size() const
+{
+    return m_values.size();
+}
+
+template <typename T>
+std::size_t SparseVector<T>::n_nonzeros() const
+{
+    return m_indices.size();
+}
+
+template <typename T>
+std::span<const std::size_t> SparseVector<T>::indices() const
+{
+    return m_indices;
+}
+
+template <typename T>
+void SparseVector<T>::set(std::size_t i, T value)
+{
+    if (i >= size())
+    {
+        throw MatrixError(fmt::format("Entry {} outside of sparse vector of size {}", i, size()));
+    }
+
+    if (!m_listed[i])
+    {
+        m_listed[i] = 1;
+        m_indices.push_back(i);
+    }
+    m_values[i] = value;
+}
+
+template <typename T>
+void SparseVector<T>::add(std::size_t i, T value)
+{
+    if (i >= size())
+    {
+        throw MatrixError(fmt::format("Entry {} outside of sparse vector of size {}", i, size()));
+    }
+
+    if (!m_listed[i])
+    {
+        m_listed[i] = 1;
+        m_indices.push_back(i);
+    }
+    m_values[i] += value;
+}
+
+template <typename T>
+void SparseVector<T>::clear()
+{
+    for (const auto i : m_indices)
+    {
+        m_values[i] = T{0};
+        m_listed[i] = 0;
+    }
+    m_indices.clear();
+}
+
+template <typename T>
+void SparseVector<T>::assign(const SparseVector& other)
+{
+    if (other.size() != size())
+    {
+        throw MatrixError(fmt::format("Cannot assign sparse vector of size {} to size {}", other.size(), size()));
+    }
+
+    clear();
+    for (const auto i : other.m_indices)
+    {
+        m_listed[i] = 1;
+        m_indices.push_back(i);
+        m_values[i] = other.m_values[i];
+    }
+}
+
+template <typename T>
+void SparseVector<T>::prune(T tolerance)
+{
+    std::size_t n_kept{0};
+    for (const auto i : m_indices)
+    {
+        if (std::abs(m_values[i]) > tolerance)
+        {
+            m_indices[n_kept++] = i;
+        }
+        else
+        {
+            m_values[i] = T{0};
+            m_listed[i] = 0;
+        }
+    }
+    m_indices.resize(n_kept);
+}
+
+template <typename T>
+Matrix<T> SparseVector<T>::make_dense() const
+{
+    Matrix<T> result{size(), 1, T{0}};
+    for (const auto i : m_indices)
+    {
+        result(i, 0) = m_values[i];
+    }
+    return result;
+}
+
+template <typename T>
+T SparseVector<T>::operator[](std::size_t i) const
+{
+    return m_values[i];
+}
+
+// SparseVector:: friend functions
+template <typename U>
+std::ostream& operator<<(std::ostream& os, const SparseVector<U>& v)
+{
+    // Coordinate format, one entry per line
+
+    os << std::fixed << std::setprecision(4);
+    os << "\n";
+    os << v.size() << "x1 (" << v.n_nonzeros() << " non-zeros)\n";
+
+    for (const auto i : v.m_indices)
+    {
+        os << "(" << i << ") " << std::setw(7) << v.m_values[i] << "\n";
+    }
+
+    return os;
+}
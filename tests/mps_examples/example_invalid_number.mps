@@ -0,0 +1,7 @@
+NAME          BADNUMBER
+ROWS
+ N  COST
+ L  LIM1
+COLUMNS
+    X1        COST      1.0       LIM1      1,0
+ENDATA
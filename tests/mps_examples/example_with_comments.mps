@@ -0,0 +1,13 @@
+* Written with Windows line endings, tabs and comments
+NAME          COMMENTS
+ROWS
+ N  COST
+*  a comment inside a section
+ L  LIM1
+
+COLUMNS
+    X1	COST	+1.5	LIM1	1e0
+    X2        COST      -2        LIM1      .5
+RHS
+    RHS       LIM1      +4
+ENDATA
@@ -0,0 +1,20 @@
+NAME          RANGED
+ROWS
+ N  COST
+ L  R1
+ G  R2
+ E  R3
+ E  R4
+COLUMNS
+    x1        COST      -1.000000000   R1        1.0000000000
+    x1        R2        1.0000000000   R3        1.0000000000
+    x2        COST      -1.000000000   R1        1.0000000000
+    x2        R2        -1.000000000   R3        2.0000000000
+    x2        R4        1.0000000000
+RHS
+    RHS       R1        6.0000000000   R2        -1.000000000
+    RHS       R3        8.0000000000   R4        1.0000000000
+RANGES
+    RNG       R1        2.0000000000   R2        3.0000000000
+    RNG       R3        -4.000000000   R4        2.0000000000
+ENDATA
@@ -0,0 +1,69 @@
+#include "test_includes.h"
+
+#include "compressed_file.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+std::string read_blocks(const std::filesystem::path& path, jsolve::CompressedFile::Format format)
+{
+    // Small blocks, so the file is split over many of them
+    jsolve::CompressedFile file{path, format, 16};
+
+    std::string text;
+    std::string block;
+
+    while (file.next_block(block))
+    {
+        REQUIRE(block.size() <= 16);
+        text += block;
+    }
+
+    return text;
+}
+} // namespace
+
+TEST_CASE("CompressedFile::detect", "[compressed_file]")
+{
+    using Format = jsolve::CompressedFile::Format;
+
+    REQUIRE(jsolve::CompressedFile::detect(get_mps("example1.mps")) == std::nullopt);
+    REQUIRE(jsolve::CompressedFile::detect(get_mps("example1.mps.gz")) == Format::GZIP);
+    REQUIRE(jsolve::CompressedFile::detect(get_mps("example1.mps.bz2")) == Format::BZIP2);
+}
+
+TEST_CASE("CompressedFile::next_block", "[compressed_file]")
+{
+    using Format = jsolve::CompressedFile::Format;
+
+    std::ifstream file{get_mps("example1.mps"), std::ios::in | std::ios::binary};
+    const std::string expected{std::istreambuf_iterator<char>{file}, {}};
+
+#ifdef JSOLVE_HAS_ZLIB
+    SECTION("gzip")
+    {
+        REQUIRE(read_blocks(get_mps("example1.mps.gz"), Format::GZIP) == expected);
+    }
+
+    SECTION("truncated gzip")
+    {
+        REQUIRE_THROWS_AS(read_blocks(get_mps("example_truncated.mps.gz"), Format::GZIP), std::runtime_error);
+    }
+#endif
+
+#ifdef JSOLVE_HAS_BZIP2
+    SECTION("bzip2")
+    {
+        REQUIRE(read_blocks(get_mps("example1.mps.bz2"), Format::BZIP2) == expected);
+    }
+#endif
+
+    SECTION("unsupported")
+    {
+        REQUIRE_FALSE(jsolve::CompressedFile::supported(Format::ZSTD));
+        REQUIRE_THROWS_AS(jsolve::CompressedFile(get_mps("example1.mps"), Format::ZSTD), std::runtime_error);
+    }
+}
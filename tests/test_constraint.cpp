@@ -94,6 +94,25 @@ TEST_CASE("constraint::rhs()", "[constraint]")
     }
 }
 
+TEST_CASE("constraint::range()", "[constraint]")
+{
+    auto c = jsolve::Constraint{jsolve::Constraint::Type::LESS, "constraint"};
+
+    SECTION("getter")
+    {
+        SECTION("default")
+        {
+            REQUIRE(c.range() == std::numeric_limits<double>::infinity());
+        }
+    }
+
+    SECTION("setter")
+    {
+        c.range() = 4;
+        REQUIRE(c.range() == 4.0);
+    }
+}
+
 TEST_CASE("constraint::add_to_lhs()", "[constraint]")
 {
     SECTION("simple")
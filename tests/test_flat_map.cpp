@@ -0,0 +1,96 @@
+#include "test_includes.h"
+
+#include "flat_map.h"
+
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("FlatMap::try_emplace", "[flat_map]")
+{
+    FlatMap<int, double> map;
+
+    SECTION("empty")
+    {
+        REQUIRE(map.empty());
+        REQUIRE(map.size() == 0);
+        REQUIRE(map.find(1) == map.end());
+    }
+
+    SECTION("kept sorted whatever the order of insertion")
+    {
+        map.try_emplace(5, 0.5);
+        map.try_emplace(1, 0.1);
+        map.try_emplace(3, 0.3);
+        map.try_emplace(7, 0.7);
+
+        std::vector<int> keys;
+        for (const auto& [key, _] : map)
+        {
+            keys.push_back(key);
+        }
+
+        REQUIRE(keys == std::vector<int>{1, 3, 5, 7});
+        REQUIRE(map.at(3) == 0.3);
+    }
+
+    SECTION("existing key is not replaced")
+    {
+        map.try_emplace(2, 1.0);
+        auto [it, inserted] = map.try_emplace(2, 4.0);
+
+        REQUIRE_FALSE(inserted);
+        REQUIRE(it->second == 1.0);
+        REQUIRE(map.size() == 1);
+    }
+}
+
+TEST_CASE("FlatMap::operator[]", "[flat_map]")
+{
+    FlatMap<int, double> map;
+
+    map[4] += 2;
+    map[2] += 1;
+    map[4] += 3;
+
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at(2) == 1.0);
+    REQUIRE(map.at(4) == 5.0);
+    REQUIRE(std::begin(map)->first == 2);
+}
+
+TEST_CASE("FlatMap::at", "[flat_map]")
+{
+    FlatMap<int, double> map;
+    map[1] = 2.0;
+
+    REQUIRE(map.at(1) == 2.0);
+    REQUIRE(map.contains(1));
+    REQUIRE_FALSE(map.contains(2));
+    REQUIRE_THROWS_AS(map.at(2), std::out_of_range);
+}
+
+TEST_CASE("FlatMap::erase", "[flat_map]")
+{
+    FlatMap<int, double> map;
+    map[1] = 1.0;
+    map[2] = 0.0;
+    map[3] = 3.0;
+    map[4] = 0.0;
+
+    SECTION("by key")
+    {
+        REQUIRE(map.erase(2) == 1);
+        REQUIRE(map.erase(2) == 0);
+        REQUIRE(map.size() == 3);
+        REQUIRE(std::next(std::begin(map))->first == 3);
+    }
+
+    SECTION("by predicate")
+    {
+        REQUIRE(map.erase_if([](const auto& pair) { return pair.second == 0.0; }) == 2);
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.contains(1));
+        REQUIRE(map.contains(3));
+    }
+}
@@ -23,18 +23,21 @@ TEST_CASE("Model::Model()", "[variable]")
         {
             auto* v1 = m.make_variable(jsolve::Variable::Type::LINEAR, "x1");
             REQUIRE(m.get_variables().size() == 1);
-            REQUIRE(m.get_variables().at("x1").get() == v1);
+            REQUIRE(m.get_variable("x1") == v1);
+            REQUIRE(m.get_variable(std::size_t{0}) == v1);
         }
 
         SECTION("two variables")
         {
-            SECTION("alphbetical sorting")
+            SECTION("insertion order")
             {
                 auto* b = m.make_variable(jsolve::Variable::Type::LINEAR, "b");
                 auto* a = m.make_variable(jsolve::Variable::Type::LINEAR, "a");
                 REQUIRE(m.get_variables().size() == 2);
-                REQUIRE(m.get_variables().at("a").get() == a);
-                REQUIRE(m.get_variables().at("b").get() == b);
+                REQUIRE(m.get_variables()[0].get() == b);
+                REQUIRE(m.get_variables()[1].get() == a);
+                REQUIRE(m.get_variable("a") == a);
+                REQUIRE(m.get_variable("b") == b);
             }
 
             SECTION("invalid - same name")
@@ -53,18 +56,21 @@ TEST_CASE("Model::Model()", "[variable]")
         {
             auto* c1 = m.make_constraint(jsolve::Constraint::Type::LESS, "a");
             REQUIRE(m.get_constraints().size() == 1);
-            REQUIRE(m.get_constraints().at("a").get() == c1);
+            REQUIRE(m.get_constraint("a") == c1);
+            REQUIRE(m.get_constraint(std::size_t{0}) == c1);
         }
 
         SECTION("two constraints")
         {
-            SECTION("alphbetical sorting")
+            SECTION("insertion order")
             {
                 auto* b = m.make_constraint(jsolve::Constraint::Type::LESS, "b");
                 auto* a = m.make_constraint(jsolve::Constraint::Type::LESS, "a");
                 REQUIRE(m.get_constraints().size() == 2);
-                REQUIRE(m.get_constraints().at("a").get() == a);
-                REQUIRE(m.get_constraints().at("b").get() == b);
+                REQUIRE(m.get_constraints()[0].get() == b);
+                REQUIRE(m.get_constraints()[1].get() == a);
+                REQUIRE(m.get_constraint("a") == a);
+                REQUIRE(m.get_constraint("b") == b);
             }
 
             SECTION("invalid - same name")
@@ -86,4 +92,56 @@ TEST_CASE("Model::Model()", "[variable]")
             REQUIRE(m.objective_name() == "test");
         }
     }
+
+    SECTION("Model::remove_variable")
+    {
+        auto m = jsolve::Model{jsolve::Model::Sense::MIN, "Example"};
+
+        auto* x1 = m.make_variable(jsolve::Variable::Type::LINEAR, "x1");
+        auto* x2 = m.make_variable(jsolve::Variable::Type::LINEAR, "x2");
+
+        auto* c1 = m.make_constraint(jsolve::Constraint::Type::LESS, "c1");
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = m.make_constraint(jsolve::Constraint::Type::LESS, "c2");
+        c2->add_to_lhs(2, x1);
+
+        SECTION("from all constraints")
+        {
+            m.remove_variable("x1");
+            REQUIRE(m.get_variable("x1") == nullptr);
+            REQUIRE(c1->entries().size() == 1);
+            REQUIRE(c2->entries().empty());
+        }
+
+        SECTION("from given constraints")
+        {
+            m.remove_variable("x1", {c1, c2});
+            REQUIRE(m.get_variable("x1") == nullptr);
+            REQUIRE(c1->entries().size() == 1);
+            REQUIRE(c2->entries().empty());
+        }
+
+        SECTION("last variable moves into its place")
+        {
+            m.remove_variable("x1");
+            REQUIRE(m.get_variables().size() == 1);
+            REQUIRE(m.get_variable(std::size_t{0}) == x2);
+            REQUIRE(m.get_variable("x2") == x2);
+        }
+    }
+
+    SECTION("Model::remove_constraint")
+    {
+        auto m = jsolve::Model{jsolve::Model::Sense::MIN, "Example"};
+
+        m.make_constraint(jsolve::Constraint::Type::LESS, "c1");
+        auto* c2 = m.make_constraint(jsolve::Constraint::Type::LESS, "c2");
+
+        m.remove_constraint("c1");
+        REQUIRE(m.get_constraint("c1") == nullptr);
+        REQUIRE(m.get_constraint("c2") == c2);
+        REQUIRE(m.get_constraint(std::size_t{0}) == c2);
+    }
 }
\ No newline at end of file
@@ -82,4 +82,85 @@ TEST_CASE("jsolve::mps::read_mps", "[matrix]")
             REQUIRE(model.get_variables().size() == 4);
         }
     }
+
+    SECTION("model with ranges")
+    {
+        // Each ranged constraint stays a single row, with the range giving its other side
+        auto model{jsolve::read_mps(get_mps("example_with_ranges.mps"))};
+
+        REQUIRE(model.get_constraints().size() == 4);
+
+        const auto* r1 = model.get_constraint("R1");
+        REQUIRE(r1->type() == jsolve::Constraint::Type::LESS);
+        REQUIRE(r1->rhs() == 6);
+        REQUIRE(r1->range() == 2);
+
+        const auto* r2 = model.get_constraint("R2");
+        REQUIRE(r2->type() == jsolve::Constraint::Type::GREAT);
+        REQUIRE(r2->rhs() == -1);
+        REQUIRE(r2->range() == 3);
+
+        // A negative range on an equality moves its lower side, a positive range its upper side
+        const auto* r3 = model.get_constraint("R3");
+        REQUIRE(r3->type() == jsolve::Constraint::Type::LESS);
+        REQUIRE(r3->rhs() == 8);
+        REQUIRE(r3->range() == 4);
+
+        const auto* r4 = model.get_constraint("R4");
+        REQUIRE(r4->type() == jsolve::Constraint::Type::GREAT);
+        REQUIRE(r4->rhs() == 1);
+        REQUIRE(r4->range() == 2);
+    }
+    SECTION("model with comments and line endings")
+    {
+        // Comment and blank lines are skipped, and tabs and carriage returns separate words
+        auto model{jsolve::read_mps(get_mps("example_with_comments.mps"))};
+
+        REQUIRE(model.name() == "COMMENTS");
+        REQUIRE(model.get_constraints().size() == 1);
+        REQUIRE(model.get_variables().size() == 2);
+
+        auto* x1 = model.get_variable("X1");
+        auto* x2 = model.get_variable("X2");
+        const auto* lim1 = model.get_constraint("LIM1");
+
+        REQUIRE(x1->cost() == 1.5);
+        REQUIRE(x2->cost() == -2);
+        REQUIRE(lim1->entries().at(x1) == 1);
+        REQUIRE(lim1->entries().at(x2) == 0.5);
+        REQUIRE(lim1->rhs() == 4);
+    }
+
+    SECTION("invalid number")
+    {
+        REQUIRE_THROWS_AS(jsolve::read_mps(get_mps("example_invalid_number.mps")), jsolve::MPSError);
+    }
+#ifdef JSOLVE_HAS_ZLIB
+    SECTION("gzip compressed model")
+    {
+        // Read in blocks as it is decompressed, giving the same model as the uncompressed file
+        auto model{jsolve::read_mps(get_mps("example1.mps.gz"))};
+
+        REQUIRE(model.name() == "TESTPROB");
+        REQUIRE(model.get_constraints().size() == 3);
+        REQUIRE(model.get_variables().size() == 3);
+        REQUIRE(model.get_constraint("LIM1")->entries().size() == 2);
+        REQUIRE(model.get_variable("ZTHREE")->cost() == 9);
+
+        REQUIRE_THROWS_AS(jsolve::read_mps(get_mps("example_truncated.mps.gz")), jsolve::MPSError);
+    }
+#endif
+
+#ifdef JSOLVE_HAS_BZIP2
+    SECTION("bzip2 compressed model")
+    {
+        auto model{jsolve::read_mps(get_mps("example1.mps.bz2"))};
+
+        REQUIRE(model.name() == "TESTPROB");
+        REQUIRE(model.get_constraints().size() == 3);
+        REQUIRE(model.get_variables().size() == 3);
+        REQUIRE(model.get_constraint("LIM1")->entries().size() == 2);
+        REQUIRE(model.get_variable("ZTHREE")->cost() == 9);
+    }
+#endif
 }
\ No newline at end of file
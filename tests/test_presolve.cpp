@@ -0,0 +1,358 @@
+#include "test_includes.h"
+
+#include "models.h"
+#include "mps.h"
+#include "presolve.h"
+#include "simplex.h"
+#include "tools.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+constexpr double infinity{std::numeric_limits<double>::infinity()};
+} // namespace
+
+TEST_CASE("jsolve::presolve")
+{
+    jsolve::Model model{jsolve::Model::Sense::MIN, "Presolve"};
+    jsolve::PostsolveStack stack;
+
+    auto* x1 = model.make_variable(jsolve::Variable::Type::LINEAR, "x1");
+    auto* x2 = model.make_variable(jsolve::Variable::Type::LINEAR, "x2");
+    auto* x3 = model.make_variable(jsolve::Variable::Type::LINEAR, "x3");
+
+    SECTION("empty row and empty column")
+    {
+        x1->cost() = 1;
+        x2->cost() = -1;
+        x2->upper_bound() = 4;
+        x3->lower_bound() = 2;
+
+        model.make_constraint(jsolve::Constraint::Type::LESS, "C1")->rhs() = 1;
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_constraints().empty());
+        REQUIRE(model.get_variables().empty());
+        REQUIRE(model.constant() == -4);
+
+        jsolve::Solution solution{model.constant(), {x1, x2, x3}, {0, 0, 0}};
+        jsolve::postsolve(stack, solution);
+
+        REQUIRE(solution.primal_of("x1") == 0);
+        REQUIRE(solution.primal_of("x2") == 4);
+        REQUIRE(solution.primal_of("x3") == 2);
+    }
+
+    SECTION("row singleton and fixed column")
+    {
+        // C1 fixes x1 = 3, which moves into the rhs of C2
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::EQUAL, "C1");
+        c1->rhs() = 6;
+        c1->add_to_lhs(2, x1);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = 5;
+        c2->add_to_lhs(1, x1);
+        c2->add_to_lhs(1, x2);
+        c2->add_to_lhs(1, x3);
+
+        auto* c3 = model.make_constraint(jsolve::Constraint::Type::GREAT, "C3");
+        c3->rhs() = 1;
+        c3->add_to_lhs(1, x2);
+        c3->add_to_lhs(-1, x3);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_variable("x1") == nullptr);
+        REQUIRE(model.get_constraint("C1") == nullptr);
+        REQUIRE(model.get_constraint("C2")->rhs() == 2);
+    }
+
+    SECTION("forcing row")
+    {
+        // Only satisfied with x1 and x2 at their upper bounds
+        x1->upper_bound() = 1;
+        x2->upper_bound() = 2;
+
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::GREAT, "C1");
+        c1->rhs() = 3;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = 10;
+        c2->add_to_lhs(1, x1);
+        c2->add_to_lhs(1, x2);
+        c2->add_to_lhs(1, x3);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_constraint("C1") == nullptr);
+        REQUIRE(model.get_variable("x1") == nullptr);
+        REQUIRE(model.get_variable("x2") == nullptr);
+    }
+
+    SECTION("parallel rows")
+    {
+        // C2 is -2 * C1, together they make x1 + x2 = 2
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+        c1->rhs() = 2;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = -4;
+        c2->add_to_lhs(-2, x1);
+        c2->add_to_lhs(-2, x2);
+
+        auto* c3 = model.make_constraint(jsolve::Constraint::Type::LESS, "C3");
+        c3->rhs() = 5;
+        c3->add_to_lhs(1, x1);
+        c3->add_to_lhs(3, x2);
+        c3->add_to_lhs(1, x3);
+
+        x3->cost() = -1;
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_constraint("C2") == nullptr);
+        REQUIRE(std::ranges::any_of(stack, [](const auto& reduction) {
+            return reduction.type == jsolve::Reduction::Type::PARALLEL_ROW && reduction.name == "C2";
+        }));
+    }
+
+    SECTION("parallel rows into a ranged row")
+    {
+        // C2 is -1 * C1, together they make 1 <= x1 + x2 <= 4
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+        c1->rhs() = 4;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = -1;
+        c2->add_to_lhs(-1, x1);
+        c2->add_to_lhs(-1, x2);
+
+        x1->cost() = 1;
+        x2->cost() = 2;
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_constraint("C2") == nullptr);
+        REQUIRE(c1->type() == jsolve::Constraint::Type::LESS);
+        REQUIRE(c1->rhs() == 4);
+        REQUIRE(c1->range() == 3);
+    }
+
+    SECTION("infeasible parallel rows")
+    {
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+        c1->rhs() = 2;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::GREAT, "C2");
+        c2->rhs() = 6;
+        c2->add_to_lhs(2, x1);
+        c2->add_to_lhs(2, x2);
+
+        x1->lower_bound() = -infinity;
+        x2->lower_bound() = -infinity;
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::INFEASIBLE);
+    }
+
+    SECTION("duplicate columns")
+    {
+        // x2 is 2 * x1 in every constraint and the objective
+        x1->cost() = 1;
+        x2->cost() = 2;
+        x3->cost() = 1;
+        x1->upper_bound() = 1;
+        x2->upper_bound() = 3;
+
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::GREAT, "C1");
+        c1->rhs() = 4;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(2, x2);
+        c1->add_to_lhs(1, x3);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = 5;
+        c2->add_to_lhs(3, x1);
+        c2->add_to_lhs(6, x2);
+        c2->add_to_lhs(-1, x3);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_variable("x2") == nullptr);
+        REQUIRE(x1->upper_bound() == 7);
+    }
+
+    SECTION("bound tightening")
+    {
+        // C1 implies x1 <= 4 and x2 <= 4, after which C3 can never be violated
+        x1->cost() = -1;
+        x2->cost() = -1;
+        x3->upper_bound() = 5;
+
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+        c1->rhs() = 4;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = 10;
+        c2->add_to_lhs(1, x1);
+        c2->add_to_lhs(2, x2);
+
+        auto* c3 = model.make_constraint(jsolve::Constraint::Type::LESS, "C3");
+        c3->rhs() = 20;
+        c3->add_to_lhs(1, x1);
+        c3->add_to_lhs(1, x2);
+        c3->add_to_lhs(1, x3);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(x1->upper_bound() == 4);
+        REQUIRE(x2->upper_bound() == 4);
+        REQUIRE(model.get_constraint("C3") == nullptr);
+    }
+
+    SECTION("doubleton equation")
+    {
+        // C1 substitutes x2 = x1, whose bounds then tighten x1 by less than propagation would
+        x1->cost() = 1;
+        x3->cost() = 1;
+        x1->upper_bound() = 2.001;
+        x2->upper_bound() = 2;
+
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::EQUAL, "C1");
+        c1->rhs() = 0;
+        c1->add_to_lhs(1, x1);
+        c1->add_to_lhs(-1, x2);
+
+        auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+        c2->rhs() = 10;
+        c2->add_to_lhs(1, x1);
+        c2->add_to_lhs(2, x3);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::REDUCED);
+        REQUIRE(model.get_variable("x2") == nullptr);
+        REQUIRE(x1->upper_bound() == 2);
+
+        auto tightened = std::ranges::find_if(stack, [](const auto& reduction) {
+            return reduction.type == jsolve::Reduction::Type::TIGHTENED_BOUNDS && reduction.name == "x1";
+        });
+        REQUIRE(tightened != std::end(stack));
+        REQUIRE(tightened->bounds == std::vector<double>{0, 2.001});
+        REQUIRE(std::next(tightened)->type == jsolve::Reduction::Type::DOUBLETON);
+    }
+
+    SECTION("infeasible row singleton")
+    {
+        x1->upper_bound() = 1;
+
+        auto* c1 = model.make_constraint(jsolve::Constraint::Type::GREAT, "C1");
+        c1->rhs() = 4;
+        c1->add_to_lhs(2, x1);
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::INFEASIBLE);
+    }
+
+    SECTION("unbounded empty column")
+    {
+        x1->cost() = -1;
+
+        REQUIRE(jsolve::presolve(model, stack) == jsolve::PresolveStatus::UNBOUNDED);
+    }
+}
+
+TEST_CASE("jsolve::postsolve")
+{
+    jsolve::Model model{jsolve::Model::Sense::MIN, "Postsolve"};
+
+    auto* x1 = model.make_variable(jsolve::Variable::Type::LINEAR, "x1");
+    auto* x2 = model.make_variable(jsolve::Variable::Type::LINEAR, "x2");
+    auto* x3 = model.make_variable(jsolve::Variable::Type::LINEAR, "x3");
+
+    SECTION("substituted variables")
+    {
+        // x3 = (12 - 2 * x1 - x2) / 4, then x2 = 1 - x1
+        jsolve::PostsolveStack stack{
+            {jsolve::Reduction::Type::FREE_COL_SINGLETON, "x3", 12, 4, {{"x1", 2}, {"x2", 1}}},
+            {jsolve::Reduction::Type::DOUBLETON, "x2", 1, 1, {{"x1", 1}}},
+            {jsolve::Reduction::Type::EMPTY_ROW, "C1"}};
+
+        jsolve::Solution solution{0, {x1, x2, x3}, {3, 0, 0}};
+        jsolve::postsolve(stack, solution);
+
+        REQUIRE(solution.primal_of("x1") == 3);
+        REQUIRE(solution.primal_of("x2") == -2);
+        REQUIRE(solution.primal_of("x3") == 2);
+    }
+
+    SECTION("duplicate columns")
+    {
+        // x1 + 2 * x2 = 5 with x1 in [0, 1] and x2 in [0, 3]
+        jsolve::PostsolveStack stack{
+            {jsolve::Reduction::Type::DUPLICATE_COL, "x2", 0, 2, {{"x1", 2}}, {0, 1, 0, 3}}};
+
+        jsolve::Solution solution{0, {x1, x2}, {5, 0}};
+        jsolve::postsolve(stack, solution);
+
+        REQUIRE(solution.primal_of("x1") == 1);
+        REQUIRE(solution.primal_of("x2") == 2);
+    }
+}
+
+TEST_CASE("jsolve::solve with presolve")
+{
+    // Presolve reductions are undone to give the same solution as solving the full model
+
+    auto check = [](auto make_model) {
+        auto full = make_model();
+        auto reduced = make_model();
+
+        auto expected = jsolve::solve(full, {.presolve = false});
+        auto solution = jsolve::solve(reduced, {.presolve = true});
+
+        REQUIRE(expected.has_value() == solution.has_value());
+
+        if (expected)
+        {
+            REQUIRE(approx_equal(expected->objective, solution->objective));
+
+            // Both solutions hold the variables of the model as it was made, in the same order
+            REQUIRE(solution->variables.size() == full.get_variables().size() - full.get_constraints().size());
+
+            for (std::size_t n_var = 0; n_var < solution->variables.size(); n_var++)
+            {
+                REQUIRE(solution->variables[n_var]->name() == expected->variables[n_var]->name());
+                REQUIRE(approx_equal(expected->primal[n_var], solution->primal[n_var]));
+            }
+        }
+    };
+
+    SECTION("model 26")
+    {
+        check(models::make_model_26);
+    }
+
+    SECTION("model 28")
+    {
+        check(models::make_model_28);
+    }
+
+    SECTION("model 29")
+    {
+        check(models::make_model_29);
+    }
+
+    SECTION("model 30")
+    {
+        check(models::make_model_30);
+    }
+
+    SECTION("model with ranges")
+    {
+        check([] { return jsolve::read_mps(get_mps("example_with_ranges.mps")); });
+    }
+}
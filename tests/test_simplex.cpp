@@ -2,6 +2,7 @@
 
 #include "models.h"
 #include "mps.h"
+#include "solve_error.h"
 #include "tools.h"
 
 #include <functional>
@@ -13,10 +14,18 @@ using test_data = std::pair<callable_alg, std::string>;
 TEST_CASE("jsolve::solve")
 {
     auto revised = [](jsolve::Model& model) {
-        return jsolve::solve(model);
+        return jsolve::solve(model, {.primal_pricing = jsolve::Options::Pricing::DANTZIG});
     };
 
-    auto [current_alg, alg_str] = GENERATE_COPY(as<test_data>{}, std::make_pair(revised, "Revised Simplex"));
+    auto revised_devex = [](jsolve::Model& model) {
+        return jsolve::solve(model, {.primal_pricing = jsolve::Options::Pricing::DEVEX});
+    };
+
+    auto [current_alg, alg_str] = GENERATE_COPY(
+        as<test_data>{},
+        std::make_pair(revised, "Revised Simplex"),
+        std::make_pair(revised_devex, "Revised Simplex (Devex)")
+    );
 
     SECTION("model 0")
     {
@@ -26,8 +35,8 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == 31.0);
-        REQUIRE(solution.value().variables.at("x1") == 4.0);
-        REQUIRE(solution.value().variables.at("x2") == 5.0);
+        REQUIRE(solution.value().primal_of("x1") == 4.0);
+        REQUIRE(solution.value().primal_of("x2") == 5.0);
     }
 
     SECTION("model 1")
@@ -38,9 +47,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == Approx(13.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 2.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 2.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1.0));
     }
 
     SECTION("model 2")
@@ -51,8 +60,8 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, -3.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 4.0 / 3.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 1.0 / 3.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 4.0 / 3.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 1.0 / 3.0));
     }
 
     SECTION("model 3")
@@ -63,10 +72,10 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == Approx(17.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 2.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x4"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 2.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), 0.0));
     }
 
     SECTION("model 4")
@@ -77,8 +86,8 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == 2.0);
-        REQUIRE(solution.value().variables.at("x1") == 1.0);
-        REQUIRE(solution.value().variables.at("x2") == 0.0);
+        REQUIRE(solution.value().primal_of("x1") == 1.0);
+        REQUIRE(solution.value().primal_of("x2") == 0.0);
     }
 
     SECTION("model 5")
@@ -89,9 +98,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == Approx(-3.0));
-        REQUIRE(solution.value().variables.at("x1") == Approx(0.0));
-        REQUIRE(solution.value().variables.at("x2") == Approx(0.5));
-        REQUIRE(solution.value().variables.at("x3") == Approx(1.5));
+        REQUIRE(solution.value().primal_of("x1") == Approx(0.0));
+        REQUIRE(solution.value().primal_of("x2") == Approx(0.5));
+        REQUIRE(solution.value().primal_of("x3") == Approx(1.5));
     }
 
     SECTION("model 6")
@@ -102,8 +111,8 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == Approx(28.0));
-        REQUIRE(solution.value().variables.at("x1") == Approx(4.0));
-        REQUIRE(solution.value().variables.at("x2") == Approx(8.0));
+        REQUIRE(solution.value().primal_of("x1") == Approx(4.0));
+        REQUIRE(solution.value().primal_of("x2") == Approx(8.0));
     }
 
     SECTION("model 7")
@@ -114,10 +123,10 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == 9.0);
-        REQUIRE(solution.value().variables.at("x1") == 0.0);
-        REQUIRE(solution.value().variables.at("x2") == 0.0);
-        REQUIRE(solution.value().variables.at("x3") == 0.0);
-        REQUIRE(solution.value().variables.at("x4") == 1.0);
+        REQUIRE(solution.value().primal_of("x1") == 0.0);
+        REQUIRE(solution.value().primal_of("x2") == 0.0);
+        REQUIRE(solution.value().primal_of("x3") == 0.0);
+        REQUIRE(solution.value().primal_of("x4") == 1.0);
     }
 
     SECTION("model 8")
@@ -128,12 +137,12 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 6.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x12"), 1.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x13"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x14"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x23"), 1.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x24"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x34"), 1.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x12"), 1.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x13"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x14"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x23"), 1.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x24"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x34"), 1.0));
     }
 
     SECTION("model 9")
@@ -144,11 +153,11 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == 8.5);
-        REQUIRE(solution.value().variables.at("x1") == 0.0);
-        REQUIRE(solution.value().variables.at("x2") == 0.5);
-        REQUIRE(solution.value().variables.at("x3") == 0.5);
-        REQUIRE(solution.value().variables.at("x4") == 0.5);
-        REQUIRE(solution.value().variables.at("x5") == 0.5);
+        REQUIRE(solution.value().primal_of("x1") == 0.0);
+        REQUIRE(solution.value().primal_of("x2") == 0.5);
+        REQUIRE(solution.value().primal_of("x3") == 0.5);
+        REQUIRE(solution.value().primal_of("x4") == 0.5);
+        REQUIRE(solution.value().primal_of("x5") == 0.5);
     }
 
     SECTION("model 10")
@@ -159,24 +168,23 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(solution.value().objective == 13.0);
-        REQUIRE(solution.value().variables.at("x1") == 3.0);
-        REQUIRE(solution.value().variables.at("x2") == 2.0);
+        REQUIRE(solution.value().primal_of("x1") == 3.0);
+        REQUIRE(solution.value().primal_of("x2") == 2.0);
     }
 
-    // This model has a cycling bug
-    // SECTION("model 11")
-    //{
-    //     INFO("Solver: " << alg_str);
-    //     auto model = models::make_model_11();
-    //     auto solution = current_alg(model);
+    SECTION("model 11")
+    {
+        INFO("Solver: " << alg_str);
+        auto model = models::make_model_11();
+        auto solution = current_alg(model);
 
-    //    REQUIRE(solution.has_value());
-    //    CHECK(solution.value().objective == 1.0);
-    //    CHECK(solution.value().variables.at("x1") == 0.0);
-    //    CHECK(solution.value().variables.at("x2") == 1.0);
-    //    CHECK(solution.value().variables.at("x3") == 0.0);
-    //    CHECK(solution.value().variables.at("x4") == 1.0);
-    //}
+        REQUIRE(solution.has_value());
+        CHECK(solution.value().objective == 1.0);
+        CHECK(solution.value().primal_of("x1") == 0.0);
+        CHECK(solution.value().primal_of("x2") == 1.0);
+        CHECK(solution.value().primal_of("x3") == 0.0);
+        CHECK(solution.value().primal_of("x4") == 1.0);
+    }
 
     SECTION("model 12")
     {
@@ -186,8 +194,8 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 25.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 5.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 5.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 5.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 5.0));
     }
 
     SECTION("model 13")
@@ -198,12 +206,12 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 7.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 3.5));
-        REQUIRE(approx_equal(solution.value().variables.at("x4"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x5"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x6"), 0.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 3.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x5"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x6"), 0.5));
     }
 
     SECTION("model 14")
@@ -223,9 +231,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 5.4));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0.2));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1.6));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0.2));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1.6));
     }
 
     SECTION("model 16")
@@ -236,9 +244,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 2.2));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.4));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1.8));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.4));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1.8));
     }
 
     SECTION("model 17")
@@ -249,10 +257,10 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 42));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0.0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 10.4));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 0));
-        REQUIRE(approx_equal(solution.value().variables.at("x4"), 0.4));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0.0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 10.4));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 0));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), 0.4));
     }
 
     SECTION("model 18")
@@ -263,9 +271,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 51 + (3.0 / 7.0)));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 6 + (3.0 / 7.0)));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 4 + (2.0 / 7.0)));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 6 + (3.0 / 7.0)));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 4 + (2.0 / 7.0)));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 0));
     }
 
     SECTION("model 19")
@@ -276,10 +284,10 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 1.5));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 2.5));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1.5));
-        REQUIRE(approx_equal(solution.value().variables.at("x4"), 0));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 2.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), 0));
     }
 
     SECTION("model 20")
@@ -290,9 +298,15 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 11));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 4));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 1));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 2));
+
+        // Every point with x1 + x2 = 5, x3 = 6 - x1 and 0 <= x1 <= 4 is optimal, which one depends on the pivots
+        const auto x1 = solution.value().primal_of("x1");
+        const auto x2 = solution.value().primal_of("x2");
+        const auto x3 = solution.value().primal_of("x3");
+        REQUIRE(approx_equal(x1 + x2, 5));
+        REQUIRE(approx_equal(x1 + x3, 6));
+        REQUIRE(x1 >= -1e-9);
+        REQUIRE(x1 <= 4 + 1e-9);
     }
 
     SECTION("model 21")
@@ -321,9 +335,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 25));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 0));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0.5));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 0.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 0));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 0.5));
     }
 
     SECTION("model 24")
@@ -336,22 +350,22 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 61.6562, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("a1"), 54.4253, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("a2"), 15.6023, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("a3"), 24.9724, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("a4"), 0.0, eps));
-
-        REQUIRE(approx_equal(solution.value().variables.at("b1"), 0.574694, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("b2"), 14.9803, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("b3"), 20.0000, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("b4"), 27.4450, eps));
-
-        REQUIRE(approx_equal(solution.value().variables.at("c1"), 0.0, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("c2"), 42.4174, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("c3"), 60.0276, eps));
-        REQUIRE(approx_equal(solution.value().variables.at("c4"), 10.5550, eps));
-
-        REQUIRE(approx_equal(solution.value().variables.at("pmax"), 11.4, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("a1"), 54.4253, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("a2"), 15.6023, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("a3"), 24.9724, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("a4"), 0.0, eps));
+
+        REQUIRE(approx_equal(solution.value().primal_of("b1"), 0.574694, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("b2"), 14.9803, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("b3"), 20.0000, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("b4"), 27.4450, eps));
+
+        REQUIRE(approx_equal(solution.value().primal_of("c1"), 0.0, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("c2"), 42.4174, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("c3"), 60.0276, eps));
+        REQUIRE(approx_equal(solution.value().primal_of("c4"), 10.5550, eps));
+
+        REQUIRE(approx_equal(solution.value().primal_of("pmax"), 11.4, eps));
     }
 
     SECTION("model with free vars")
@@ -363,6 +377,17 @@ TEST_CASE("jsolve::solve")
         REQUIRE(approx_equal(solution.value().objective, -5.733333, 1e-4));
     }
 
+    SECTION("model with ranges")
+    {
+        auto model{jsolve::read_mps(get_mps("example_with_ranges.mps"))};
+        auto solution = current_alg(model);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, -6));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 4));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 2));
+    }
+
     SECTION("model 25")
     {
         INFO("Solver: " << alg_str);
@@ -371,9 +396,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 6));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 1));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 1));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1));
     }
 
     SECTION("model 26")
@@ -384,9 +409,9 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 6));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 1));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 1));
-        REQUIRE(approx_equal(solution.value().variables.at("x3"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1));
     }
 
     SECTION("model 28")
@@ -397,8 +422,163 @@ TEST_CASE("jsolve::solve")
 
         REQUIRE(solution.has_value());
         REQUIRE(approx_equal(solution.value().objective, 0));
-        REQUIRE(approx_equal(solution.value().variables.at("x1"), 5));
-        REQUIRE(approx_equal(solution.value().variables.at("x2"), 0));
-        REQUIRE(!solution.value().variables.contains("x3")); // Fixed variable is replaced by a constant
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 5));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0));
+        REQUIRE(solution.value().primal_of("x3") == 5.0); // Fixed variable stays at its bound
+    }
+
+    SECTION("model 29")
+    {
+        INFO("Solver: " << alg_str);
+        auto model = models::make_model_29();
+        auto solution = current_alg(model);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, 2));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), -2));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 3));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), -1));
+    }
+
+    SECTION("model 30")
+    {
+        INFO("Solver: " << alg_str);
+        auto model = models::make_model_30();
+        auto solution = current_alg(model);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, 4.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 0.5));
     }
 }
+
+TEST_CASE("jsolve::parse_pricing")
+{
+    REQUIRE(jsolve::parse_pricing("dantzig") == jsolve::Options::Pricing::DANTZIG);
+    REQUIRE(jsolve::parse_pricing("devex") == jsolve::Options::Pricing::DEVEX);
+    REQUIRE_THROWS_AS(jsolve::parse_pricing("steepest"), jsolve::SolveError);
+}
+
+TEST_CASE("jsolve::solve with crash")
+{
+    // A crashed starting basis reaches the same optimum as the all slack basis
+    const jsolve::Options options{.crash = jsolve::Options::Crash::BIXBY};
+
+    SECTION("model 4")
+    {
+        auto model = models::make_model_4();
+        auto solution = jsolve::solve(model, options);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, 2));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 0));
+    }
+
+    SECTION("model 29")
+    {
+        auto model = models::make_model_29();
+        auto solution = jsolve::solve(model, options);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, 2));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), -2));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 3));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x4"), -1));
+    }
+
+    SECTION("model 30")
+    {
+        auto model = models::make_model_30();
+        auto solution = jsolve::solve(model, options);
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution.value().objective, 4.5));
+        REQUIRE(approx_equal(solution.value().primal_of("x1"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x2"), 1));
+        REQUIRE(approx_equal(solution.value().primal_of("x3"), 0.5));
+    }
+}
+
+TEST_CASE("jsolve::solve with perturbation")
+{
+    // Models that stall long enough to be perturbed reach the optimum of the unperturbed model. The perturbed solve
+    // takes a different path, so its iterations (cleanup passes included) differ from the unperturbed solve.
+    auto solve = [](jsolve::Model& model, bool perturbation) {
+        auto solution = jsolve::solve(model, {.presolve = false, .perturbation = perturbation});
+        REQUIRE(solution.has_value());
+        return solution.value();
+    };
+
+    SECTION("model 11")
+    {
+        // Cycles under the textbook rules, but is too short to stall for long enough to be perturbed
+        for (const auto perturbation : {true, false})
+        {
+            INFO("Perturbation: " << perturbation);
+            auto model = models::make_model_11();
+            auto solution = solve(model, perturbation);
+
+            REQUIRE(solution.objective == 1.0);
+            REQUIRE(approx_equal(solution.primal_of("x2"), 1.0));
+            REQUIRE(approx_equal(solution.primal_of("x4"), 1.0));
+        }
+    }
+
+    SECTION("model 31")
+    {
+        // Perturbs bounds in the primal
+        auto perturbed_model = models::make_model_31();
+        auto unperturbed_model = models::make_model_31();
+        auto perturbed = solve(perturbed_model, true);
+        auto unperturbed = solve(unperturbed_model, false);
+
+        REQUIRE(perturbed.n_iterations != unperturbed.n_iterations);
+
+        for (const auto& solution : {perturbed, unperturbed})
+        {
+            REQUIRE(approx_equal(solution.objective, 95.0 / 3.0));
+
+            double sum{0.0};
+            for (const auto value : solution.primal)
+            {
+                REQUIRE(value >= -1e-9);
+                sum += value;
+            }
+            REQUIRE(sum <= 10 + 1e-9);
+        }
+    }
+
+    SECTION("model 32")
+    {
+        // Perturbs costs in the dual
+        auto perturbed_model = models::make_model_32();
+        auto unperturbed_model = models::make_model_32();
+        auto perturbed = solve(perturbed_model, true);
+        auto unperturbed = solve(unperturbed_model, false);
+
+        REQUIRE(perturbed.n_iterations != unperturbed.n_iterations);
+
+        for (const auto& solution : {perturbed, unperturbed})
+        {
+            REQUIRE(approx_equal(solution.objective, 5));
+
+            for (const auto value : solution.primal)
+            {
+                REQUIRE(value >= -1e-9);
+                REQUIRE(value <= 1 + 1e-9);
+            }
+        }
+    }
+}
+
+TEST_CASE("jsolve::parse_crash")
+{
+    REQUIRE(jsolve::parse_crash("none") == jsolve::Options::Crash::NONE);
+    REQUIRE(jsolve::parse_crash("bixby") == jsolve::Options::Crash::BIXBY);
+    REQUIRE_THROWS_AS(jsolve::parse_crash("ltsf"), jsolve::SolveError);
+}
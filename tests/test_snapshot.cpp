@@ -0,0 +1,113 @@
+#include "test_includes.h"
+
+#include "mps.h"
+#include "snapshot.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace
+{
+std::filesystem::path snapshot_path(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / ("jsolve_test_" + name + ".snap");
+}
+} // namespace
+
+TEST_CASE("jsolve::snapshot", "[snapshot]")
+{
+    SECTION("model 1 round trip")
+    {
+        const auto path = snapshot_path("example1");
+        jsolve::write_snapshot(jsolve::read_mps(get_mps("example1.mps")), path);
+
+        auto model{jsolve::read_snapshot(path)};
+        std::filesystem::remove(path);
+
+        REQUIRE(model.name() == "TESTPROB");
+        REQUIRE(model.sense() == jsolve::Model::Sense::MIN);
+        REQUIRE(model.get_constraints().size() == 3);
+        REQUIRE(model.get_variables().size() == 3);
+
+        auto* x1 = model.get_variable("XONE");
+        auto* y2 = model.get_variable("YTWO");
+        auto* z3 = model.get_variable("ZTHREE");
+
+        REQUIRE(x1->cost() == 1);
+        REQUIRE(y2->cost() == 4);
+        REQUIRE(z3->cost() == 9);
+        REQUIRE(x1->upper_bound() == 4);
+        REQUIRE(y2->lower_bound() == 1);
+        REQUIRE(z3->upper_bound() == std::numeric_limits<double>::infinity());
+
+        // Variables keep the order they were read in
+        REQUIRE(model.get_variables().front()->name() == "XONE");
+
+        const auto* myeqn = model.get_constraint("MYEQN");
+        REQUIRE(myeqn->type() == jsolve::Constraint::Type::EQUAL);
+        REQUIRE(myeqn->rhs() == 7);
+        REQUIRE(myeqn->entries().size() == 2);
+        REQUIRE(myeqn->entries().at(y2) == -1);
+        REQUIRE(myeqn->entries().at(z3) == 1);
+    }
+
+    SECTION("model with ranges round trip")
+    {
+        const auto path = snapshot_path("ranges");
+        jsolve::write_snapshot(jsolve::read_mps(get_mps("example_with_ranges.mps")), path);
+
+        auto model{jsolve::read_snapshot(path)};
+        std::filesystem::remove(path);
+
+        REQUIRE(model.get_constraints().size() == 4);
+
+        const auto* r3 = model.get_constraint("R3");
+        REQUIRE(r3->type() == jsolve::Constraint::Type::LESS);
+        REQUIRE(r3->rhs() == 8);
+        REQUIRE(r3->range() == 4);
+        REQUIRE(r3->entries().at(model.get_variable("x2")) == 2);
+
+        REQUIRE(model.get_constraint("R1")->range() == 2);
+    }
+
+    SECTION("not a snapshot")
+    {
+        REQUIRE_THROWS_AS(jsolve::read_snapshot(get_mps("example1.mps")), jsolve::SnapshotError);
+    }
+
+    SECTION("duplicate entry")
+    {
+        const auto path = snapshot_path("duplicate");
+        jsolve::write_snapshot(jsolve::read_mps(get_mps("example1.mps")), path);
+
+        // The offset of the row indices is the 14th word of the header. XONE is the first column, with entries in
+        // LIM1 and LIM2, so pointing its second entry at its first row gives it two entries in LIM1.
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        std::uint64_t row_indices{0};
+        file.seekg(13 * sizeof(std::uint64_t));
+        file.read(reinterpret_cast<char*>(&row_indices), sizeof(row_indices));
+
+        std::uint32_t first_row{0};
+        file.seekg(static_cast<std::streamoff>(row_indices));
+        file.read(reinterpret_cast<char*>(&first_row), sizeof(first_row));
+        file.seekp(static_cast<std::streamoff>(row_indices + sizeof(first_row)));
+        file.write(reinterpret_cast<const char*>(&first_row), sizeof(first_row));
+        file.close();
+
+        REQUIRE_THROWS_WITH(jsolve::read_snapshot(path), "Snapshot has two entries for XONE in LIM1");
+        std::filesystem::remove(path);
+    }
+
+    SECTION("truncated snapshot")
+    {
+        const auto path = snapshot_path("truncated");
+        jsolve::write_snapshot(jsolve::read_mps(get_mps("example1.mps")), path);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+        REQUIRE_THROWS_AS(jsolve::read_snapshot(path), jsolve::SnapshotError);
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,180 @@
+#include "test_includes.h"
+
+#include "mps.h"
+#include "simplex.h"
+#include "solution.h"
+#include "tools.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+jsolve::Model make_model(jsolve::Model::Sense sense)
+{
+    // max 3x + 2y (or min -3x - 2y) st C1: x + y <= 4, C2: x + 3y <= 7, x <= 3, y <= 2
+    // Optimal at x = 3, y = 1 with C1 tight, so C1 has dual 2 and x a reduced cost of 3 - 2 = 1 (for max).
+    // The bounds are tighter than the rows imply, so presolve leaves the model as it is.
+
+    const double c = sense == jsolve::Model::Sense::MAX ? 1.0 : -1.0;
+
+    jsolve::Model model{sense, "Duals"};
+
+    auto* x = model.make_variable(jsolve::Variable::Type::LINEAR, "x");
+    auto* y = model.make_variable(jsolve::Variable::Type::LINEAR, "y");
+    x->cost() = 3 * c;
+    y->cost() = 2 * c;
+    x->upper_bound() = 3;
+    y->upper_bound() = 2;
+
+    auto* c1 = model.make_constraint(jsolve::Constraint::Type::LESS, "C1");
+    c1->add_to_lhs(1, x);
+    c1->add_to_lhs(1, y);
+    c1->rhs() = 4;
+
+    auto* c2 = model.make_constraint(jsolve::Constraint::Type::LESS, "C2");
+    c2->add_to_lhs(1, x);
+    c2->add_to_lhs(3, y);
+    c2->rhs() = 7;
+
+    return model;
+}
+} // namespace
+
+TEST_CASE("jsolve::Solution", "[solution]")
+{
+    const auto presolve = GENERATE(false, true);
+    INFO("Presolve: " << presolve);
+
+    SECTION("max")
+    {
+        auto model = make_model(jsolve::Model::Sense::MAX);
+        auto solution = jsolve::solve(model, {.presolve = presolve});
+
+        REQUIRE(solution.has_value());
+        REQUIRE(solution->has_duals());
+        REQUIRE(approx_equal(solution->objective, 11.0));
+
+        // In the order of the model as made, without slacks
+        REQUIRE(solution->variables.size() == 2);
+        REQUIRE(solution->variables[0]->name() == "x");
+        REQUIRE(solution->constraints[1]->name() == "C2");
+
+        REQUIRE(approx_equal(solution->primal[0], 3.0));
+        REQUIRE(approx_equal(solution->primal[1], 1.0));
+        REQUIRE(approx_equal(solution->reduced_costs[0], 1.0));
+        REQUIRE(approx_equal(solution->reduced_costs[1], 0.0));
+        REQUIRE(approx_equal(solution->duals[0], 2.0));
+        REQUIRE(approx_equal(solution->duals[1], 0.0));
+    }
+
+    SECTION("min")
+    {
+        auto model = make_model(jsolve::Model::Sense::MIN);
+        auto solution = jsolve::solve(model, {.presolve = presolve});
+
+        REQUIRE(solution.has_value());
+        REQUIRE(approx_equal(solution->objective, -11.0));
+        REQUIRE(approx_equal(solution->primal_of("y"), 1.0));
+        REQUIRE(approx_equal(solution->reduced_costs[0], -1.0));
+        REQUIRE(approx_equal(solution->duals[0], -2.0));
+    }
+}
+
+TEST_CASE("jsolve::Solution after presolve", "[solution]")
+{
+    // Presolve changes each of these models, so only the values are given, and they match a solve without presolve
+    const auto name = GENERATE(as<std::string>{}, "example1", "example2", "example3", "example5", "example_with_ranges");
+    INFO("Model: " << name);
+
+    auto original = jsolve::read_mps(get_mps(name + ".mps"));
+    auto without = jsolve::solve(original, {.presolve = false});
+    REQUIRE(without.has_value());
+    REQUIRE(without->has_duals());
+
+    auto presolved = jsolve::read_mps(get_mps(name + ".mps"));
+    auto with = jsolve::solve(presolved, {.presolve = true});
+    REQUIRE(with.has_value());
+    REQUIRE(approx_equal(with->objective, without->objective, 1e-6));
+
+    REQUIRE_FALSE(with->has_duals());
+    REQUIRE(with->duals.empty());
+    REQUIRE(with->reduced_costs.empty());
+
+    // Presolve is off unless asked for, so the default options keep the duals
+    auto by_default = jsolve::read_mps(get_mps(name + ".mps"));
+    auto solution = jsolve::solve(by_default);
+    REQUIRE(solution.has_value());
+    REQUIRE(solution->has_duals());
+}
+
+TEST_CASE("jsolve::write_solution", "[solution]")
+{
+    const auto read_lines = [](const jsolve::Solution& solution) {
+        const auto path = std::filesystem::temp_directory_path() / "jsolve_test_solution.txt";
+        jsolve::write_solution(solution, path);
+
+        std::ifstream file{path};
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(file, line);)
+        {
+            lines.push_back(line);
+        }
+        file.close();
+        std::filesystem::remove(path);
+        return lines;
+    };
+
+    SECTION("with duals")
+    {
+        auto model = make_model(jsolve::Model::Sense::MAX);
+        auto solution = jsolve::solve(model, {.presolve = false});
+        REQUIRE(solution.has_value());
+
+        const auto lines = read_lines(solution.value());
+
+        REQUIRE(lines.size() == 7);
+        REQUIRE(lines[0].starts_with("OBJECTIVE "));
+        REQUIRE(lines[1] == "COLUMNS");
+        REQUIRE(lines[4] == "ROWS");
+
+        std::istringstream x_line{lines[2]};
+        std::string name;
+        double value{0.0};
+        double reduced_cost{0.0};
+        x_line >> name >> value >> reduced_cost;
+
+        REQUIRE(name == "x");
+        REQUIRE(value == solution->primal[0]);
+        REQUIRE(reduced_cost == solution->reduced_costs[0]);
+        REQUIRE(lines[5].starts_with("C1 "));
+    }
+
+    SECTION("without duals")
+    {
+        auto model = make_model(jsolve::Model::Sense::MAX);
+        auto solution = jsolve::solve(model, {.presolve = false});
+        REQUIRE(solution.has_value());
+
+        solution->reduced_costs.clear();
+        solution->duals.clear();
+
+        const auto lines = read_lines(solution.value());
+
+        // Only the values are written, without a ROWS section
+        REQUIRE(lines.size() == 4);
+        REQUIRE(lines[1] == "COLUMNS");
+
+        std::istringstream x_line{lines[2]};
+        std::string name;
+        double value{0.0};
+        std::string rest;
+        x_line >> name >> value >> rest;
+
+        REQUIRE(name == "x");
+        REQUIRE(value == solution->primal[0]);
+        REQUIRE(rest.empty());
+    }
+}
@@ -0,0 +1,329 @@
+#include "test_includes.h"
+
+#include "solve_error.h"
+#include "sparse_lu.h"
+#include "sparse_matrix.h"
+#include "sparse_vector.h"
+
+using Matr = Matrix<double>;
+using SparseMatr = SparseMatrix<double>;
+
+namespace
+{
+Matr make_column(std::vector<double> values)
+{
+    Matr result{values.size(), 1, 0.0};
+    for (std::size_t i{0}; i < values.size(); i++)
+    {
+        result(i, 0) = values[i];
+    }
+    return result;
+}
+
+bool columns_equal(const Matr& lhs, const Matr& rhs, double eps = 1e-10)
+{
+    for (std::size_t i{0}; i < lhs.n_rows(); i++)
+    {
+        if (!approx_equal(lhs(i, 0), rhs(i, 0), eps))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Matr make_example()
+{
+    // Needs pivoting (zero leading entry) and produces fill-in
+    Matr A{4, 4, 0.0};
+    A(0, 1) = 2;
+    A(0, 3) = 1;
+    A(1, 0) = 4;
+    A(1, 1) = 1;
+    A(2, 0) = -1;
+    A(2, 2) = 3;
+    A(2, 3) = 1;
+    A(3, 0) = 2;
+    A(3, 2) = 1;
+    A(3, 3) = 5;
+    return A;
+}
+} // namespace
+
+TEST_CASE("SparseLU::SparseLU", "[sparse_lu]")
+{
+    SECTION("identity has no fill-in")
+    {
+        SparseMatr I{3, 3, {{0, 0, 1}, {1, 1, 1}, {2, 2, 1}}};
+
+        jsolve::SparseLU<double> lu{I};
+
+        REQUIRE(lu.size() == 3);
+        REQUIRE(lu.stats().basis_nonzeros == 3);
+        REQUIRE(lu.stats().l_nonzeros == 0);
+        REQUIRE(lu.stats().u_nonzeros == 3);
+        REQUIRE(lu.stats().fill_in() == 0);
+        REQUIRE(lu.stats().n_singletons == 3);
+    }
+
+    SECTION("triangular matrix has no fill-in")
+    {
+        SparseMatr U{3, 3, {{0, 0, 2}, {0, 1, 1}, {0, 2, 1}, {1, 1, 3}, {1, 2, 1}, {2, 2, 4}}};
+
+        jsolve::SparseLU<double> lu{U};
+
+        REQUIRE(lu.stats().fill_in() == 0);
+        REQUIRE(lu.stats().l_nonzeros == 0);
+    }
+
+    SECTION("non-square")
+    {
+        SparseMatr A{3, 2, {{0, 0, 1}, {1, 1, 1}}};
+        REQUIRE_THROWS_AS(jsolve::SparseLU<double>{A}, jsolve::SolveError);
+    }
+
+    SECTION("singular")
+    {
+        SparseMatr A{3, 3, {{0, 0, 1}, {1, 0, 1}, {0, 1, 2}, {1, 1, 2}, {2, 2, 1}}};
+        REQUIRE_THROWS_AS(jsolve::SparseLU<double>{A}, jsolve::SolveError);
+    }
+
+    SECTION("empty column")
+    {
+        SparseMatr A{2, 2, {{0, 0, 1}, {1, 0, 1}}};
+        REQUIRE_THROWS_AS(jsolve::SparseLU<double>{A}, jsolve::SolveError);
+    }
+
+    SECTION("subset of columns")
+    {
+        SparseMatr A{2, 4, {{0, 0, 5}, {1, 1, 3}, {0, 2, 1}, {1, 3, 1}}};
+        std::vector<std::size_t> columns{3, 0};
+
+        jsolve::SparseLU<double> lu{A, columns};
+
+        // Basis is [e2 | 5 * e1]
+        auto x = lu.solve(make_column({10, 2}));
+        REQUIRE(columns_equal(x, make_column({2, 2})));
+    }
+}
+
+TEST_CASE("SparseLU::solve", "[sparse_lu]")
+{
+    auto A = make_example();
+    jsolve::SparseLU<double> lu{SparseMatr{A}};
+
+    SECTION("unit vectors")
+    {
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            Matr e{4, 1, 0.0};
+            e(i, 0) = 1;
+            auto x = lu.solve(e);
+            REQUIRE(columns_equal(A * x, e));
+        }
+    }
+
+    SECTION("general rhs")
+    {
+        auto b = make_column({1, -2, 3.5, 0.25});
+        auto x = lu.solve(b);
+        REQUIRE(columns_equal(A * x, b));
+    }
+
+    SECTION("invalid rhs")
+    {
+        REQUIRE_THROWS_AS(lu.solve(Matr{3, 1}), jsolve::SolveError);
+    }
+}
+
+TEST_CASE("SparseLU::transpose_solve", "[sparse_lu]")
+{
+    auto A = make_example();
+    jsolve::SparseLU<double> lu{SparseMatr{A}};
+
+    SECTION("general rhs")
+    {
+        auto b = make_column({1, -2, 3.5, 0.25});
+        auto x = lu.transpose_solve(b);
+        REQUIRE(columns_equal(A.make_transpose() * x, b));
+    }
+
+    SECTION("unit vectors")
+    {
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            Matr e{4, 1, 0.0};
+            e(i, 0) = 1;
+            auto x = lu.transpose_solve(e);
+            REQUIRE(columns_equal(A.make_transpose() * x, e));
+        }
+    }
+}
+
+TEST_CASE("SparseLU threshold pivoting", "[sparse_lu]")
+{
+    // A tiny leading entry must not be chosen as a pivot when it fails the threshold test
+    Matr A{2, 2, 0.0};
+    A(0, 0) = 1e-7;
+    A(0, 1) = 1;
+    A(1, 0) = 1;
+    A(1, 1) = 1;
+
+    jsolve::SparseLU<double> lu{SparseMatr{A}};
+
+    auto b = make_column({1, 2});
+    auto x = lu.solve(b);
+
+    REQUIRE(columns_equal(A * x, b, 1e-12));
+}
+
+TEST_CASE("SparseLU::update", "[sparse_lu]")
+{
+    auto A = make_example();
+    jsolve::SparseLU<double> lu{SparseMatr{A}};
+
+    auto replace = [&](std::size_t col, Matr a) {
+        SparseVector<double> spike{4};
+        auto x = lu.solve(SparseVector<double>{a}, &spike);
+        bool stable = lu.update(col, spike, x[col]);
+
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            A(i, col) = a(i, 0);
+        }
+        return stable;
+    };
+
+    SECTION("single replacement")
+    {
+        REQUIRE(replace(1, make_column({1, 0, 2, -1})));
+        REQUIRE(lu.stats().n_updates == 1);
+
+        auto b = make_column({1, -2, 3.5, 0.25});
+        REQUIRE(columns_equal(A * lu.solve(b), b));
+        REQUIRE(columns_equal(A.make_transpose() * lu.transpose_solve(b), b));
+    }
+
+    SECTION("repeated replacements")
+    {
+        REQUIRE(replace(0, make_column({3, 0, 0, 1})));
+        REQUIRE(replace(3, make_column({0, 1, 1, 0})));
+        REQUIRE(replace(0, make_column({1, 1, 1, 1})));
+        REQUIRE(replace(2, make_column({0, 0, 2, 0})));
+        REQUIRE(lu.stats().n_updates == 4);
+
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            Matr e{4, 1, 0.0};
+            e(i, 0) = 1;
+            REQUIRE(columns_equal(A * lu.solve(e), e));
+            REQUIRE(columns_equal(A.make_transpose() * lu.transpose_solve(e), e));
+        }
+
+        // Agrees with a fresh factorisation
+        jsolve::SparseLU<double> fresh{SparseMatr{A}};
+        auto b = make_column({1, -2, 3.5, 0.25});
+        REQUIRE(columns_equal(lu.solve(b), fresh.solve(b)));
+        REQUIRE(columns_equal(lu.transpose_solve(b), fresh.transpose_solve(b)));
+    }
+
+    SECTION("singular replacement is unstable")
+    {
+        // Column 0 replaced by a copy of column 2
+        REQUIRE_FALSE(replace(0, make_column({0, 0, 3, 1})));
+    }
+
+    SECTION("invalid")
+    {
+        REQUIRE_THROWS_AS(lu.update(4, SparseVector<double>{4}, 1.0), jsolve::SolveError);
+        REQUIRE_THROWS_AS(lu.update(0, SparseVector<double>{3}, 1.0), jsolve::SolveError);
+    }
+}
+
+TEST_CASE("SparseLU hypersparse solves", "[sparse_lu]")
+{
+    // The symbolic (reachability) solves must match the plain solves
+    auto A = make_example();
+
+    jsolve::SparseLU<double> hyper{SparseMatr{A}, {.hyper_density = 2.0}};
+    jsolve::SparseLU<double> plain{SparseMatr{A}, {.hyper_density = 0.0}};
+
+    auto check = [&]() {
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            SparseVector<double> e{4};
+            e.set(i, 1.0);
+
+            auto x = hyper.solve(e);
+            REQUIRE(columns_equal(x.make_dense(), plain.solve(e).make_dense()));
+            REQUIRE(columns_equal(A * x.make_dense(), e.make_dense()));
+
+            auto y = hyper.transpose_solve(e);
+            REQUIRE(columns_equal(y.make_dense(), plain.transpose_solve(e).make_dense()));
+            REQUIRE(columns_equal(A.make_transpose() * y.make_dense(), e.make_dense()));
+        }
+    };
+
+    SECTION("fresh factorisation")
+    {
+        check();
+    }
+
+    SECTION("after updates")
+    {
+        auto replace = [&](std::size_t col, Matr a) {
+            SparseVector<double> hyper_spike{4};
+            SparseVector<double> plain_spike{4};
+            auto x = hyper.solve(SparseVector<double>{a}, &hyper_spike);
+            plain.solve(SparseVector<double>{a}, &plain_spike);
+            hyper.update(col, hyper_spike, x[col]);
+            plain.update(col, plain_spike, x[col]);
+
+            for (std::size_t i{0}; i < 4; i++)
+            {
+                A(i, col) = a(i, 0);
+            }
+        };
+
+        replace(1, make_column({1, 0, 2, -1}));
+        replace(3, make_column({0, 1, 1, 0}));
+        check();
+    }
+
+    SECTION("solves into a reused buffer")
+    {
+        // Entries left by an earlier solve must not leak into the next
+        SparseVector<double> x{4};
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            SparseVector<double> e{4};
+            e.set(i, 1.0);
+
+            hyper.solve(e, x);
+            REQUIRE(columns_equal(A * x.make_dense(), e.make_dense()));
+
+            hyper.transpose_solve(e, x);
+            REQUIRE(columns_equal(A.make_transpose() * x.make_dense(), e.make_dense()));
+        }
+
+        SparseVector<double> short_x{3};
+        REQUIRE_THROWS_AS(hyper.solve(SparseVector<double>{4}, short_x), jsolve::SolveError);
+    }
+
+    SECTION("only reachable entries are visited")
+    {
+        // Diagonal matrix, a unit rhs gives a result with a single non-zero
+        jsolve::SparseLU<double> lu{SparseMatr{3, 3, {{0, 0, 2}, {1, 1, 4}, {2, 2, 8}}}};
+
+        SparseVector<double> e{3};
+        e.set(1, 1.0);
+
+        auto x = lu.solve(e);
+        REQUIRE(x.n_nonzeros() == 1);
+        REQUIRE(x[1] == 0.25);
+
+        auto y = lu.transpose_solve(e);
+        REQUIRE(y.n_nonzeros() == 1);
+        REQUIRE(y[1] == 0.25);
+    }
+}
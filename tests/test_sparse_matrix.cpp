@@ -0,0 +1,269 @@
+#include "test_includes.h"
+
+#include "matrix.h"
+#include "sparse_matrix.h"
+
+using Matr = Matrix<double>;
+using SparseMatr = SparseMatrix<double>;
+
+namespace
+{
+Matr make_dense_example()
+{
+    // [1 0 2]
+    // [0 0 3]
+    // [4 5 0]
+    // [0 0 6]
+    Matr A{4, 3, 0.0};
+    A(0, 0) = 1;
+    A(0, 2) = 2;
+    A(1, 2) = 3;
+    A(2, 0) = 4;
+    A(2, 1) = 5;
+    A(3, 2) = 6;
+    return A;
+}
+} // namespace
+
+TEST_CASE("SparseMatrix::SparseMatrix(row,col)", "[sparse_matrix]")
+{
+    SECTION("construction - invalid")
+    {
+        REQUIRE_THROWS_AS(SparseMatr(0, 0), MatrixError);
+        REQUIRE_THROWS_AS(SparseMatr(0, 3), MatrixError);
+    }
+
+    SECTION("construction - valid")
+    {
+        SparseMatr m{3, 6};
+        REQUIRE(m.n_rows() == 3);
+        REQUIRE(m.n_cols() == 6);
+        REQUIRE(m.n_nonzeros() == 0);
+        REQUIRE(m(2, 5) == 0.0);
+    }
+}
+
+TEST_CASE("SparseMatrix::SparseMatrix(row,col,entries)", "[sparse_matrix]")
+{
+    SECTION("unordered entries")
+    {
+        SparseMatr m{4, 3, {{3, 2, 6}, {0, 2, 2}, {2, 1, 5}, {0, 0, 1}, {1, 2, 3}, {2, 0, 4}}};
+
+        REQUIRE(m.n_nonzeros() == 6);
+        REQUIRE(m == SparseMatr{make_dense_example()});
+        REQUIRE(m.make_dense() == make_dense_example());
+    }
+
+    SECTION("duplicates are summed")
+    {
+        SparseMatr m{2, 2, {{0, 1, 1.5}, {1, 0, 2}, {0, 1, 2.5}}};
+
+        REQUIRE(m.n_nonzeros() == 2);
+        REQUIRE(m(0, 1) == 4.0);
+        REQUIRE(m(1, 0) == 2.0);
+    }
+
+    SECTION("zeros are dropped")
+    {
+        SparseMatr m{2, 2, {{0, 0, 0.0}, {1, 1, 1.0}, {1, 0, 3.0}, {1, 0, -3.0}}};
+
+        REQUIRE(m.n_nonzeros() == 1);
+        REQUIRE(m(1, 1) == 1.0);
+        REQUIRE(m.col_indices(0).empty());
+    }
+
+    SECTION("entry out of range")
+    {
+        REQUIRE_THROWS_AS(SparseMatr(2, 2, {{2, 0, 1.0}}), MatrixError);
+        REQUIRE_THROWS_AS(SparseMatr(2, 2, {{0, 2, 1.0}}), MatrixError);
+    }
+}
+
+TEST_CASE("SparseMatrix compressed access", "[sparse_matrix]")
+{
+    SparseMatr m{make_dense_example()};
+
+    SECTION("columns")
+    {
+        auto rows = m.col_indices(2);
+        auto values = m.col_values(2);
+
+        REQUIRE(rows.size() == 3);
+        REQUIRE(rows[0] == 0);
+        REQUIRE(rows[1] == 1);
+        REQUIRE(rows[2] == 3);
+        REQUIRE(values[0] == 2);
+        REQUIRE(values[1] == 3);
+        REQUIRE(values[2] == 6);
+    }
+
+    SECTION("rows")
+    {
+        auto cols = m.row_indices(2);
+        auto values = m.row_values(2);
+
+        REQUIRE(cols.size() == 2);
+        REQUIRE(cols[0] == 0);
+        REQUIRE(cols[1] == 1);
+        REQUIRE(values[0] == 4);
+        REQUIRE(values[1] == 5);
+    }
+
+    SECTION("dense column")
+    {
+        auto col = m.column(0);
+
+        REQUIRE(col.n_rows() == 4);
+        REQUIRE(col.n_cols() == 1);
+        REQUIRE(col(0, 0) == 1);
+        REQUIRE(col(1, 0) == 0);
+        REQUIRE(col(2, 0) == 4);
+        REQUIRE(col(3, 0) == 0);
+
+        REQUIRE_THROWS_AS(m.column(3), MatrixError);
+    }
+
+    SECTION("sparse column")
+    {
+        auto col = m.sparse_column(2);
+
+        REQUIRE(col.size() == 4);
+        REQUIRE(col.n_nonzeros() == 3);
+        REQUIRE(col.make_dense() == m.column(2));
+    }
+
+    SECTION("element access")
+    {
+        REQUIRE(m(0, 2) == 2);
+        REQUIRE(m(1, 1) == 0);
+        REQUIRE_THROWS_AS(m(4, 0), MatrixError);
+    }
+}
+
+TEST_CASE("SparseMatrix::make_transpose", "[sparse_matrix]")
+{
+    SparseMatr m{make_dense_example()};
+
+    auto t = m.make_transpose();
+
+    REQUIRE(t.n_rows() == 3);
+    REQUIRE(t.n_cols() == 4);
+    REQUIRE(t.n_nonzeros() == m.n_nonzeros());
+    REQUIRE(t.make_dense() == make_dense_example().make_transpose());
+    REQUIRE(t.make_transpose() == m);
+}
+
+TEST_CASE("SparseMatrix::set_column", "[sparse_matrix]")
+{
+    SparseMatr m{make_dense_example()};
+    SparseMatr source{4, 2, {{1, 1, 7}, {3, 1, 8}}};
+
+    SECTION("replace with more entries")
+    {
+        m.set_column(1, source, 1);
+        m.refresh_rows();
+
+        auto expected = make_dense_example();
+        expected(2, 1) = 0;
+        expected(1, 1) = 7;
+        expected(3, 1) = 8;
+
+        REQUIRE(m.make_dense() == expected);
+        REQUIRE(m.n_nonzeros() == 7);
+        REQUIRE(m.row_indices(3).size() == 2);
+    }
+
+    SECTION("rows follow a run of replacements")
+    {
+        m.set_column(1, source, 1);
+        m.set_column(0, source, 1);
+        m.set_column(2, source, 0);
+        m.refresh_rows();
+
+        SparseMatr expected{4, 3, {{1, 0, 7}, {3, 0, 8}, {1, 1, 7}, {3, 1, 8}}};
+
+        REQUIRE(m == expected);
+        REQUIRE(m.make_transpose().make_dense() == expected.make_dense().make_transpose());
+        REQUIRE(m.row_indices(2).empty());
+        REQUIRE(m.row_values(3)[1] == 8);
+    }
+
+    SECTION("replace with empty column")
+    {
+        m.set_column(2, source, 0);
+
+        auto expected = make_dense_example();
+        expected(0, 2) = 0;
+        expected(1, 2) = 0;
+        expected(3, 2) = 0;
+
+        REQUIRE(m.make_dense() == expected);
+        REQUIRE(m.n_nonzeros() == 3);
+    }
+
+    SECTION("invalid")
+    {
+        REQUIRE_THROWS_AS(m.set_column(3, source, 0), MatrixError);
+        REQUIRE_THROWS_AS(m.set_column(0, SparseMatr{3, 1}, 0), MatrixError);
+    }
+}
+
+TEST_CASE("SparseMatrix scaling", "[sparse_matrix]")
+{
+    SparseMatr m{make_dense_example()};
+
+    m.scale_rows({1, 2, 3, 4});
+    m.scale_cols({10, 1, 0.5});
+
+    auto expected = make_dense_example();
+    for (std::size_t i{0}; i < expected.n_rows(); i++)
+    {
+        for (std::size_t j{0}; j < expected.n_cols(); j++)
+        {
+            expected(i, j) *= static_cast<double>(i + 1) * std::vector<double>{10, 1, 0.5}[j];
+        }
+    }
+
+    REQUIRE(m.make_dense() == expected);
+    REQUIRE(m.make_transpose().make_dense() == expected.make_transpose());
+}
+
+TEST_CASE("SparseMatrix multiplication", "[sparse_matrix]")
+{
+    SparseMatr m{make_dense_example()};
+
+    SECTION("sparse * dense")
+    {
+        Matr x{3, 1, 0.0};
+        x(0, 0) = 1;
+        x(1, 0) = 2;
+        x(2, 0) = 3;
+
+        REQUIRE((m * x) == (make_dense_example() * x));
+    }
+
+    SECTION("transpose multiply")
+    {
+        Matr y{4, 1, 0.0};
+        y(0, 0) = 1;
+        y(1, 0) = -1;
+        y(2, 0) = 2;
+        y(3, 0) = 0.5;
+
+        REQUIRE(m.transpose_multiply(y) == (make_dense_example().make_transpose() * y));
+        REQUIRE(m.transpose_multiply(y) == (m.make_transpose() * y));
+        REQUIRE_THROWS_AS(m.transpose_multiply(Matr{3, 1}), MatrixError);
+    }
+
+    SECTION("transpose multiply sparse")
+    {
+        SparseVector<double> y{4};
+        y.set(2, 2);
+        y.set(0, 1);
+
+        Matr dense_y{y.make_dense()};
+
+        REQUIRE(m.transpose_multiply(y) == m.transpose_multiply(dense_y));
+        REQUIRE_THROWS_AS(m.transpose_multiply(SparseVector<double>{3}), MatrixError);
+    }
+}
@@ -0,0 +1,114 @@
+#include "test_includes.h"
+
+#include "matrix.h"
+#include "sparse_vector.h"
+
+using Matr = Matrix<double>;
+using SparseVec = SparseVector<double>;
+
+TEST_CASE("SparseVector::SparseVector", "[sparse_vector]")
+{
+    SECTION("empty")
+    {
+        SparseVec v{5};
+        REQUIRE(v.size() == 5);
+        REQUIRE(v.n_nonzeros() == 0);
+        REQUIRE(v[3] == 0.0);
+    }
+
+    SECTION("from indices and values")
+    {
+        std::vector<std::size_t> indices{3, 0};
+        std::vector<double> values{1.5, -2};
+
+        SparseVec v{4, indices, values};
+
+        REQUIRE(v.n_nonzeros() == 2);
+        REQUIRE(v[0] == -2.0);
+        REQUIRE(v[3] == 1.5);
+        REQUIRE(v[1] == 0.0);
+
+        std::vector<std::size_t> out_of_range{4};
+        std::vector<double> one{1};
+        REQUIRE_THROWS_AS(SparseVec(4, out_of_range, one), MatrixError);
+        REQUIRE_THROWS_AS(SparseVec(4, indices, one), MatrixError);
+    }
+
+    SECTION("from dense")
+    {
+        Matr dense{4, 1, 0.0};
+        dense(1, 0) = 3;
+        dense(2, 0) = 4;
+
+        SparseVec v{dense};
+
+        REQUIRE(v.n_nonzeros() == 2);
+        REQUIRE(v.make_dense() == dense);
+        REQUIRE_THROWS_AS(SparseVec(Matr{2, 2}), MatrixError);
+    }
+}
+
+TEST_CASE("SparseVector modifiers", "[sparse_vector]")
+{
+    SparseVec v{6};
+
+    SECTION("set and add")
+    {
+        v.set(4, 2.0);
+        v.add(4, 1.0);
+        v.add(1, -1.0);
+
+        REQUIRE(v.n_nonzeros() == 2);
+        REQUIRE(v[4] == 3.0);
+        REQUIRE(v[1] == -1.0);
+        REQUIRE_THROWS_AS(v.set(6, 1.0), MatrixError);
+        REQUIRE_THROWS_AS(v.add(6, 1.0), MatrixError);
+    }
+
+    SECTION("clear")
+    {
+        v.set(0, 1.0);
+        v.set(5, 1.0);
+        v.clear();
+
+        REQUIRE(v.n_nonzeros() == 0);
+        REQUIRE(v[0] == 0.0);
+        REQUIRE(v[5] == 0.0);
+
+        v.add(5, 2.0);
+        REQUIRE(v.n_nonzeros() == 1);
+        REQUIRE(v[5] == 2.0);
+    }
+
+    SECTION("assign")
+    {
+        v.set(0, 1.0);
+        v.set(5, 1.0);
+
+        SparseVec other{6};
+        other.set(3, 2.0);
+        v.assign(other);
+
+        REQUIRE(v.n_nonzeros() == 1);
+        REQUIRE(v[0] == 0.0);
+        REQUIRE(v[3] == 2.0);
+        REQUIRE(v[5] == 0.0);
+        REQUIRE_THROWS_AS(v.assign(SparseVec{5}), MatrixError);
+    }
+
+    SECTION("prune cancelled entries")
+    {
+        v.set(2, 1.0);
+        v.add(2, -1.0);
+        v.set(3, 1e-15);
+        v.set(4, 5.0);
+
+        REQUIRE(v.n_nonzeros() == 3);
+
+        v.prune(1e-14);
+
+        REQUIRE(v.n_nonzeros() == 1);
+        REQUIRE(v.indices()[0] == 4);
+        REQUIRE(v[3] == 0.0);
+    }
+}